@@ -0,0 +1,44 @@
+#ifndef GLFWIM_BENCH_HPP
+#define GLFWIM_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <utility>
+
+namespace glfwim::bench {
+    // keeps the compiler from dropping a computation whose result is otherwise unused
+    template <typename T>
+    inline void doNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // Runs the whole measurement a few times and reports the best one per operation, which is the least
+    // disturbed by scheduling noise. setup runs before each repetition and is not timed.
+    template <typename S, typename F>
+    void measure(const char* name, size_t operations, S&& setup, F&& run) {
+        double best = std::numeric_limits<double>::infinity();
+        for (int repetition = 0; repetition < 5; ++repetition) {
+            setup();
+            auto start = std::chrono::steady_clock::now();
+            run();
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        std::printf("  %-56s %10.2f ns/op\n", name, best / operations);
+    }
+
+    template <typename F>
+    void measure(const char* name, size_t operations, F&& run) {
+        measure(name, operations, [](){}, std::forward<F>(run));
+    }
+
+    void dispatchFrames();
+    void inlineFunction();
+    void modalCycles();
+    void tasks();
+}
+
+#endif
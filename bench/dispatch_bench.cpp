@@ -0,0 +1,145 @@
+// handleEvents() frame cost with 1k key and 1k cursor position handlers, against a model of the former scheme that
+// moved every handler vector out before dispatch and back after it (backupContainer/restoreContainer) so handlers
+// could register handlers while being called. The InputManager event frames also pay for the GLFW stub callbacks
+// (event queueing, the cursor move's snapshot publish), which the baseline skips, so they err on its side.
+#include "bench.hpp"
+
+#include <glfwim/input_manager.hpp>
+#include <glfw_stub.hpp>
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace glfwim::bench {
+    namespace {
+        constexpr int Frames = 5000;
+        constexpr int HandlerCount = 1000;
+        constexpr int Scancodes = 100;
+
+        struct BackupRestoreBaseline {
+            template <typename T>
+            struct Holder {
+                T handler;
+                int priority;
+                bool enabled;
+            };
+
+            std::vector<Holder<InlineFunction<void(int, Modifier, Action)>>> keyHandlers;
+            std::vector<Holder<InlineFunction<void(double, double)>>> cursorHandlers;
+            int currentPriority = 0;
+
+            template <typename Container>
+            static Container backupContainer(Container& container) {
+                auto ret = std::move(container);
+                container.clear();
+                return ret;
+            }
+
+            template <typename Container>
+            static void restoreContainer(Container& container, Container& backup) {
+                std::swap(container, backup);
+                if (!backup.empty()) {
+                    container.insert(std::end(container), std::make_move_iterator(std::begin(backup)), std::make_move_iterator(std::end(backup)));
+                }
+            }
+
+            // handlers registered during dispatch land in the emptied live container and are appended on restore
+            template <typename F>
+            void frame(int keyEvents, int cursorEvents, F&& duringDispatch) {
+                auto tempKeyHandlers = backupContainer(keyHandlers);
+                for (int e = 0; e < keyEvents; ++e) {
+                    for (auto& h : tempKeyHandlers) {
+                        if (h.enabled && currentPriority >= h.priority) h.handler(10 + e, Modifier::None, Action::Press);
+                    }
+                }
+                duringDispatch();
+                restoreContainer(keyHandlers, tempKeyHandlers);
+
+                auto tempCursorHandlers = backupContainer(cursorHandlers);
+                for (int e = 0; e < cursorEvents; ++e) {
+                    for (auto& h : tempCursorHandlers) {
+                        if (h.enabled && currentPriority >= h.priority) h.handler(e, e);
+                    }
+                }
+                restoreContainer(cursorHandlers, tempCursorHandlers);
+            }
+        };
+
+        void baseline(int& calls) {
+            BackupRestoreBaseline dispatcher;
+            // per scancode handlers filter inside the wrapper like the former registerKeyHandler(scancode, ...)
+            for (int i = 0; i < HandlerCount; ++i) {
+                dispatcher.keyHandlers.push_back({[&calls, code = 10 + i % Scancodes](int scancode, Modifier, Action) {
+                    if (scancode == code) ++calls;
+                }, 0, true});
+                dispatcher.cursorHandlers.push_back({[&calls](double, double) { ++calls; }, 0, true});
+            }
+            auto nothing = []() {};
+
+            measure("backup/restore baseline: empty frame", Frames, [&]() {
+                for (int frame = 0; frame < Frames; ++frame) {
+                    dispatcher.frame(0, 0, nothing);
+                    doNotOptimize(dispatcher);
+                }
+            });
+            measure("backup/restore baseline: key press, release, cursor move", Frames, [&]() {
+                for (int frame = 0; frame < Frames; ++frame) {
+                    dispatcher.frame(2, 1, nothing);
+                    doNotOptimize(dispatcher);
+                }
+            });
+            measure("backup/restore baseline: frame with one add and remove", Frames, [&]() {
+                for (int frame = 0; frame < Frames; ++frame) {
+                    dispatcher.frame(0, 0, [&]() {
+                        dispatcher.keyHandlers.push_back({[&calls](int, Modifier, Action) { ++calls; }, 0, true});
+                    });
+                    dispatcher.keyHandlers.pop_back();
+                    doNotOptimize(dispatcher);
+                }
+            });
+        }
+
+        void inputManager(int& calls) {
+            auto window = glfwstub::createWindow();
+            auto im = std::make_unique<InputManager>();
+            im->initialize(window);
+            for (int i = 0; i < HandlerCount; ++i) {
+                im->registerKeyHandler(10 + i % Scancodes, [&calls](Modifier, Action) { ++calls; });
+                im->registerCursorPositionHandler([&calls](double, double) { ++calls; });
+            }
+            im->handleEvents();
+
+            measure("handleEvents(): empty frame", Frames, [&]() {
+                for (int frame = 0; frame < Frames; ++frame) im->handleEvents();
+            });
+            measure("handleEvents(): key press, release, cursor move", Frames, [&]() {
+                for (int frame = 0; frame < Frames; ++frame) {
+                    glfwstub::key(window, 'A', 10, GLFW_PRESS);
+                    glfwstub::key(window, 'A', 10, GLFW_RELEASE);
+                    glfwstub::cursorPos(window, frame % 1280, frame % 720);
+                    im->handleEvents();
+                }
+            });
+            std::optional<InputManager::CallbackHandler> pending;
+            measure("handleEvents(): frame with one pending add and remove", Frames, [&]() {
+                for (int frame = 0; frame < Frames; ++frame) {
+                    if (pending) pending->remove();
+                    pending = im->registerKeyHandler(10, [&calls](Modifier, Action) { ++calls; });
+                    im->handleEvents();
+                }
+            });
+            if (pending) pending->remove();
+
+            im.reset();
+            glfwstub::destroyWindow(window);
+        }
+    }
+
+    void dispatchFrames() {
+        int calls = 0;
+        baseline(calls);
+        inputManager(calls);
+        doNotOptimize(calls);
+    }
+}
@@ -0,0 +1,68 @@
+// InlineFunction against std::function for what the handler registries do with them: build one from a wrapped
+// user lambda at registration, then call a list of them per event.
+#include "bench.hpp"
+
+#include <glfwim/inline_function.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace glfwim::bench {
+    namespace {
+        constexpr int HandlerCount = 16;
+        constexpr int DispatchRounds = 200000;
+        constexpr int Constructions = 1000000;
+
+        // the size of a registerKeyHandler() wrapper around a user lambda with a couple of captures
+        struct Captures {
+            int* counter;
+            int key;
+            int mods;
+            void* user[3];
+        };
+
+        template <typename Function>
+        std::vector<Function> makeHandlers(int* counter) {
+            std::vector<Function> handlers;
+            for (int i = 0; i < HandlerCount; ++i) {
+                Captures c{counter, i, 0, {}};
+                handlers.emplace_back([c](int key, int action) {
+                    if (key == c.key) *c.counter += action;
+                    return false;
+                });
+            }
+            return handlers;
+        }
+
+        template <typename Function>
+        void dispatch(const char* name) {
+            int counter = 0;
+            auto handlers = makeHandlers<Function>(&counter);
+            measure(name, (size_t)DispatchRounds * HandlerCount, [&]() {
+                for (int round = 0; round < DispatchRounds; ++round) {
+                    for (auto& h : handlers) doNotOptimize(h(round % HandlerCount, 1));
+                }
+            });
+            doNotOptimize(counter);
+        }
+
+        template <typename Function>
+        void construct(const char* name) {
+            int counter = 0;
+            measure(name, Constructions, [&]() {
+                for (int i = 0; i < Constructions; ++i) {
+                    Captures c{&counter, i, 0, {}};
+                    Function f{[c](int key, int action) { *c.counter += key + action; return false; }};
+                    doNotOptimize(f);
+                }
+            });
+        }
+    }
+
+    void inlineFunction() {
+        dispatch<std::function<bool(int, int)>>("dispatch, std::function");
+        dispatch<InlineFunction<bool(int, int)>>("dispatch, InlineFunction");
+        construct<std::function<bool(int, int)>>("construct + destroy, std::function");
+        construct<InlineFunction<bool(int, int)>>("construct + destroy, InlineFunction");
+    }
+}
@@ -0,0 +1,25 @@
+#include "bench.hpp"
+
+#include <cstring>
+
+// glfwim_bench [filter]: runs the benchmarks whose name contains filter, all of them without one
+int main(int argc, char** argv) {
+    using namespace glfwim;
+    const char* filter = argc > 1 ? argv[1] : "";
+    struct Benchmark {
+        const char* name;
+        void (*run)();
+    };
+    const Benchmark benchmarks[] = {
+        { "dispatch_frames", bench::dispatchFrames },
+        { "inline_function", bench::inlineFunction },
+        { "modal_cycles", bench::modalCycles },
+        { "tasks", bench::tasks },
+    };
+    for (auto& benchmark : benchmarks) {
+        if (std::strstr(benchmark.name, filter) == nullptr) continue;
+        std::printf("%s\n", benchmark.name);
+        benchmark.run();
+    }
+    return 0;
+}
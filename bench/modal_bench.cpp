@@ -0,0 +1,56 @@
+// Modal dialog open/close cycles: keys pressed while the modal is open are released artificially to the modal's
+// handlers when it closes, which costs O(pressed keys x matching handlers) with the dense pressed key list.
+#include "bench.hpp"
+
+#include <glfwim/input_manager.hpp>
+#include <glfw_stub.hpp>
+
+#include <memory>
+
+namespace glfwim::bench {
+    namespace {
+        constexpr int Cycles = 20000;
+        constexpr int HandlersPerLayer = 8;
+        constexpr int ModalPriority = 1;
+
+        void cycles(const char* name, int heldKeys) {
+            auto window = glfwstub::createWindow();
+            auto im = std::make_unique<InputManager>();
+            im->initialize(window);
+
+            // a game layer and a modal layer, each with per key handlers and one catch-all
+            int calls = 0;
+            for (int priority : { 0, ModalPriority }) {
+                im->setDefaultHandlerPriority(priority);
+                for (int i = 0; i < HandlersPerLayer - 1; ++i) {
+                    im->registerKeyHandler(10 + i, [&calls](Modifier, Action) { ++calls; });
+                }
+                im->registerKeyHandler([&calls](int, Modifier, Action) { ++calls; });
+            }
+            im->handleEvents();
+
+            measure(name, Cycles, [&]() {
+                for (int cycle = 0; cycle < Cycles; ++cycle) {
+                    im->setCurrentKeyboardHandlerPriority(ModalPriority);
+                    for (int k = 0; k < heldKeys; ++k) glfwstub::key(window, 'A' + k, 10 + k, GLFW_PRESS);
+                    im->handleEvents();
+                    // closing the modal releases the held keys to its handlers
+                    im->setCurrentKeyboardHandlerPriority(0);
+                    im->handleEvents();
+                    for (int k = 0; k < heldKeys; ++k) glfwstub::key(window, 'A' + k, 10 + k, GLFW_RELEASE);
+                    im->handleEvents();
+                }
+            });
+            doNotOptimize(calls);
+
+            im.reset();
+            glfwstub::destroyWindow(window);
+        }
+    }
+
+    void modalCycles() {
+        cycles("open/close cycle, no keys held", 0);
+        cycles("open/close cycle, 4 keys held", 4);
+        cycles("open/close cycle, 32 keys held", 32);
+    }
+}
@@ -0,0 +1,112 @@
+// Task queue throughput: producer threads submit tasks that the main thread runs through runTasks(), measured
+// end to end per task, from the first submission until the last task has run. The drain measurements time
+// runTasks() alone over a queue filled beforehand.
+#include "bench.hpp"
+
+#include <glfwim/input_manager.hpp>
+#include <glfw_stub.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace glfwim::bench {
+    namespace {
+        constexpr int TasksPerProducer = 100000;
+        constexpr int BatchSize = 64;
+
+        // produce(im, count, task) submits count copies of task, it runs on each producer thread
+        template <typename Produce>
+        void throughput(const char* name, int producers, Produce produce) {
+            auto window = glfwstub::createWindow();
+            auto im = std::make_unique<InputManager>();
+            im->initialize(window);
+
+            const int total = producers * TasksPerProducer;
+            measure(name, total, [&]() {
+                // only touched by the tasks, which all run on this thread
+                int done = 0;
+                std::vector<std::thread> threads;
+                for (int p = 0; p < producers; ++p) {
+                    threads.emplace_back([&]() { produce(*im, TasksPerProducer, [&done]() { ++done; }); });
+                }
+                while (done < total) im->runTasks();
+                for (auto& t : threads) t.join();
+            });
+
+            im.reset();
+            glfwstub::destroyWindow(window);
+        }
+
+        // postBulk() moves out of the batch, which leaves these trivially copyable tasks intact for the next one
+        template <typename Task>
+        void postBulkBatches(auto& target, int count, Task task) {
+            std::vector<Task> batch(BatchSize, task);
+            for (int i = 0; i < count; i += BatchSize) target.postBulk(batch.begin(), std::min(BatchSize, count - i));
+        }
+
+        template <typename Task>
+        void executeOnBulkBatches(auto& target, int count, Task task) {
+            std::vector<Task> batch(BatchSize, task);
+            for (int i = 0; i < count; i += BatchSize) target.executeOnBulk(batch.begin(), std::min(BatchSize, count - i));
+        }
+
+        // runTasks() alone, over TasksPerProducer tasks queued by another thread beforehand
+        void drain() {
+            auto window = glfwstub::createWindow();
+            auto im = std::make_unique<InputManager>();
+            im->initialize(window);
+
+            int done = 0;
+            auto fill = [&]() {
+                std::thread{[&]() { postBulkBatches(*im, TasksPerProducer, [&done]() { ++done; }); }}.join();
+            };
+            measure("drain, runTasks (bulk dequeue)", TasksPerProducer, fill, [&]() { im->runTasks(); });
+            doNotOptimize(done);
+
+            // the same queue drained one element at a time, the way runTasks() used to
+            moodycamel::ConcurrentQueue<InlineFunction<void()>> queue;
+            auto fillQueue = [&]() {
+                std::thread{[&]() {
+                    for (int i = 0; i < TasksPerProducer; ++i) queue.enqueue([&done]() { ++done; });
+                }}.join();
+            };
+            measure("drain, try_dequeue one at a time", TasksPerProducer, fillQueue, [&]() {
+                InlineFunction<void()> task;
+                while (queue.try_dequeue(task)) task();
+            });
+            doNotOptimize(done);
+
+            im.reset();
+            glfwstub::destroyWindow(window);
+        }
+    }
+
+    void tasks() {
+        for (int producers : { 1, 4 }) {
+            std::printf("  %d producer(s)\n", producers);
+            throughput("executeOn (packaged_task + future)", producers, [](InputManager& im, int count, auto task) {
+                for (int i = 0; i < count; ++i) im.executeOn(task);
+            });
+            throughput("post", producers, [](InputManager& im, int count, auto task) {
+                for (int i = 0; i < count; ++i) im.post(task);
+            });
+            throughput("TaskProducer::post (producer token)", producers, [](InputManager& im, int count, auto task) {
+                auto producer = im.createTaskProducer();
+                for (int i = 0; i < count; ++i) producer.post(task);
+            });
+            throughput("postBulk, batches of 64", producers, [](InputManager& im, int count, auto task) {
+                postBulkBatches(im, count, task);
+            });
+            throughput("TaskProducer::postBulk, batches of 64", producers, [](InputManager& im, int count, auto task) {
+                auto producer = im.createTaskProducer();
+                postBulkBatches(producer, count, task);
+            });
+            throughput("executeOnBulk, batches of 64", producers, [](InputManager& im, int count, auto task) {
+                executeOnBulkBatches(im, count, task);
+            });
+        }
+        drain();
+    }
+}
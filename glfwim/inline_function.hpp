@@ -0,0 +1,95 @@
+#ifndef INLINE_FUNCTION_HPP
+#define INLINE_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef GLFWIM_INLINE_FUNCTION_CAPACITY
+#define GLFWIM_INLINE_FUNCTION_CAPACITY 64
+#endif
+
+namespace glfwim {
+    template <typename Signature, size_t Capacity = GLFWIM_INLINE_FUNCTION_CAPACITY>
+    class InlineFunction;
+
+    // Move-only replacement for std::function that always stores the callable inline and never allocates.
+    // A callable that does not fit is rejected at compile time; raise the capacity for that instantiation
+    // or globally through GLFWIM_INLINE_FUNCTION_CAPACITY.
+    template <typename R, typename... Args, size_t Capacity>
+    class InlineFunction<R(Args...), Capacity> {
+    public:
+        InlineFunction() = default;
+        InlineFunction(std::nullptr_t) {}
+
+        template <typename F>
+            requires (!std::is_same_v<std::decay_t<F>, InlineFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+        InlineFunction(F&& f) {
+            using T = std::decay_t<F>;
+            static_assert(sizeof(T) <= Capacity, "callable does not fit into the inline storage of InlineFunction");
+            static_assert(alignof(T) <= alignof(std::max_align_t), "callable is over-aligned for InlineFunction");
+            static_assert(std::is_nothrow_move_constructible_v<T>, "InlineFunction needs a nothrow movable callable");
+
+            ::new (static_cast<void*>(storage)) T(std::forward<F>(f));
+            invoker = [](void* callable, Args&&... args) -> R {
+                if constexpr (std::is_void_v<R>) {
+                    std::invoke(*static_cast<T*>(callable), std::forward<Args>(args)...);
+                } else {
+                    return std::invoke(*static_cast<T*>(callable), std::forward<Args>(args)...);
+                }
+            };
+            manager = [](void* dst, void* src) {
+                if (dst != nullptr) ::new (dst) T(std::move(*static_cast<T*>(src)));
+                static_cast<T*>(src)->~T();
+            };
+        }
+
+        InlineFunction(InlineFunction&& that) noexcept {
+            moveFrom(that);
+        }
+
+        InlineFunction& operator=(InlineFunction&& that) noexcept {
+            if (this != &that) {
+                reset();
+                moveFrom(that);
+            }
+            return *this;
+        }
+
+        InlineFunction& operator=(std::nullptr_t) noexcept {
+            reset();
+            return *this;
+        }
+
+        ~InlineFunction() { reset(); }
+
+        R operator()(Args... args) const {
+            return invoker(storage, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const { return invoker != nullptr; }
+
+    private:
+        void reset() {
+            if (manager != nullptr) manager(nullptr, storage);
+            invoker = nullptr;
+            manager = nullptr;
+        }
+
+        void moveFrom(InlineFunction& that) {
+            if (that.manager == nullptr) return;
+            that.manager(storage, that.storage);
+            invoker = std::exchange(that.invoker, nullptr);
+            manager = std::exchange(that.manager, nullptr);
+        }
+
+    private:
+        alignas(std::max_align_t) mutable unsigned char storage[Capacity];
+        R (*invoker)(void*, Args&&...) = nullptr;
+        // move constructs the callable into dst (when not null), then destroys the one in src
+        void (*manager)(void* dst, void* src) = nullptr;
+    };
+}
+#endif
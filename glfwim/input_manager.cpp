@@ -2,35 +2,17 @@
 #include <GLFW/glfw3.h>
 
 namespace glfwim {
-    PerFrameMonitorData::PerFrameMonitorData(const PerFrameMonitorData& that) {
-        videoMode = std::make_unique<GLFWvidmode>(*that.videoMode);
-        posX = that.posX;
-        posY = that.posY;
-        workAreaX = that.workAreaX;
-        workAreaY = that.workAreaY;
-        workAreaW = that.workAreaW;
-        workAreaH = that.workAreaH;
-        scaleX = that.scaleX;
-        scaleY = that.scaleY;
-    }
-
-    PerFrameMonitorData& PerFrameMonitorData::operator=(const PerFrameMonitorData& that) {
-        videoMode = std::make_unique<GLFWvidmode>(*that.videoMode);
-        posX = that.posX;
-        posY = that.posY;
-        workAreaX = that.workAreaX;
-        workAreaY = that.workAreaY;
-        workAreaW = that.workAreaW;
-        workAreaH = that.workAreaH;
-        scaleX = that.scaleX;
-        scaleY = that.scaleY;
-
-        return *this;
+    // joystick callbacks must not reach a destroyed manager
+    InputManager::~InputManager() {
+        if (joystickOwner == this) joystickOwner = nullptr;
     }
 
     void InputManager::initialize(GLFWwindow* window) {
         mainThreadId = std::this_thread::get_id();
-        keyStates.resize(GLFW_KEY_LAST, -1);
+        pressedKeyPositions.assign(GLFW_KEY_LAST + 1, -1);
+        pressedKeys.reserve(16);
+        mouseButtonStates.fill(-1);
+        rebuildKeyNameTable();
         this->window = window;
 
         glfwSetWindowUserPointer(window, this);
@@ -42,57 +24,84 @@ namespace glfwim {
             for (int i = 0; i < count; ++i) {
                 vpaths.push_back(paths[i]);
             }
-            inputManager.pathDropEventQueue.emplace(std::move(vpaths));
+            inputManager.pathDropPayloads.enqueue(std::move(vpaths));
+            inputManager.pushEvent(window, PathDropEvent{});
         });
 
         glfwSetKeyCallback(window, [](auto window, int key, int scancode, int action, int mods) {
             auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
-            inputManager.keyEventQueue.emplace(key, scancode, Modifier{mods}, Action{action});
+            inputManager.pushEvent(window, KeyEvent{key, scancode, Modifier{mods}, Action{action}, inputManager.keyNameFor(key, scancode)});
+            inputManager.restartKeyHolds(scancode, action);
+            if (key >= 0 && key < PerFrameGlobalInputData::KeyBitWords * 64) {
+                updateButtonBits(inputManager.keyDownBits[key / 64], inputManager.keyPressedBits[key / 64], inputManager.keyReleasedBits[key / 64], key % 64, action);
+                inputManager.dirtyFields |= KeyboardField;
+            }
         });
 
         glfwSetMouseButtonCallback(window, [](auto window, int button, int action, int mods) {
             auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
-            inputManager.mouseButtonEventQueue.emplace(MouseButton{button}, Modifier{mods}, Action{action});
+            inputManager.pushEvent(window, MouseButtonEvent{MouseButton{button}, Modifier{mods}, Action{action}});
+            updateButtonBits(inputManager.mouseButtonDownBits, inputManager.mouseButtonPressedBits, inputManager.mouseButtonReleasedBits, button, action);
+            inputManager.dirtyFields |= MouseButtonField | MainViewportField;
         });
 
         glfwSetScrollCallback(window, [](auto window, double x, double y) {
             auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
-            inputManager.mouseScrollEventQueue.emplace(x, y); 
+            inputManager.pushEvent(window, MouseScrollEvent{x, y});
         });
 
         glfwSetCursorEnterCallback(window, [](auto window, int entered) {
             auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
-            inputManager.cursorMovementEventQueue.emplace(CursorMovement{ !!entered });
+            inputManager.pushEvent(window, CursorMovementEvent{CursorMovement{ !!entered }});
+            inputManager.dirtyFields |= MainViewportField;
         });
 
         glfwSetCursorPosCallback(window, [](auto window, double x, double y) {
             auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
-            inputManager.cursorPositionEventQueue.emplace(x, y);
+            inputManager.pushEvent(window, CursorPositionEvent{x, y});
+            if (window == inputManager.window) inputManager.restartCursorHolds(x, y);
+            inputManager.dirtyFields |= MainViewportField;
             inputManager.updateInputState();
         });
 
         glfwSetFramebufferSizeCallback(window, [](auto window, int x, int y) {
             auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
             inputManager.lastResizeTime.store(glfwGetTime(), std::memory_order::relaxed);
-            inputManager.windowResizeEventQueue.emplace(x, y);
+            inputManager.pushEvent(window, WindowResizeEvent{x, y});
+            inputManager.dirtyFields |= WindowSizeField | MainViewportField;
             inputManager.updateInputState();
         });
 
         glfwSetWindowPosCallback(window, [](auto window, int x, int y) {
             auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
-            inputManager.windowMoveEventQueue.emplace(x, y); 
+            inputManager.pushEvent(window, WindowMoveEvent{x, y});
+            inputManager.dirtyFields |= MainViewportField;
             inputManager.updateInputState();
         });
 
         glfwSetWindowFocusCallback(window, [](auto window, int focused) {
             auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
-            inputManager.windowFocusEventQueue.emplace(focused);
+            inputManager.pushEvent(window, WindowFocusEvent{!!focused});
+            // the clipboard can only change behind our back while another window has the focus
+            if (focused) {
+                // the keyboard layout may have been switched while we were in the background
+                inputManager.rebuildKeyNameTable();
+                inputManager.clipboardStale.store(true);
+            }
+            // no GLFW event reports work area changes (e.g. a moved taskbar), focus regain is the closest hint
+            inputManager.dirtyFields |= MainViewportField | (focused ? unsigned(MonitorField) : 0u);
+            inputManager.updateInputState();
+        });
+
+        glfwSetWindowContentScaleCallback(window, [](auto window, float, float) {
+            auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
+            inputManager.dirtyFields |= MonitorField;
             inputManager.updateInputState();
         });
 
         glfwSetWindowCloseCallback(window, [](auto window) {
             auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
-            inputManager.windowCloseEventQueue.emplace();
+            inputManager.pushEvent(window, WindowCloseEvent{});
             inputManager.updateInputState();
         });
 
@@ -112,245 +121,934 @@ namespace glfwim {
             }
             if (im != nullptr) {
                 glfwSetMonitorUserPointer(monitor, im);
-                im->monitorStateChangedEventQueue.emplace(monitor, event);
+                im->pushEvent(nullptr, MonitorStateChangedEvent{monitor, event});
+                im->dirtyFields |= MonitorField;
             }
         });
 
         glfwSetCharCallback(window, [](auto window, unsigned int codepoint) {
             auto& inputManager = *(InputManager*)glfwGetWindowUserPointer(window);
-            inputManager.textEventQueue.emplace(codepoint);
+            inputManager.pushEvent(window, TextEvent{codepoint});
+        });
+
+        glfwSetJoystickCallback([](int jid, int event) {
+            if (joystickOwner != nullptr) joystickOwner->setJoystickConnected(jid, event == GLFW_CONNECTED);
         });
+        if (joystickOwner == nullptr) claimJoysticks();
 
         currentKeyboardPriority = previousKeyboardPriority = currentMousePriority = previousMousePriority = defaultPriority = 0;
         registerWindow(window);
-        globalInputState = new PerFrameGlobalInputData{};
-        previousState = new PerFrameGlobalInputData{};
-        fillInputState(previousState);
-        fillInputState(globalInputState);
+        fillInputState(&snapshots[0].data);
+        publishedSnapshot.store(0);
+        recordHistory(snapshots[0].data);
+        dirtyFields = 0;
     }
 
+    // Sleeps until the next event, cursor hold deadline or joystick poll, whichever comes first; post()
+    // from other threads and new cursor hold handlers wake it through glfwPostEmptyEvent().
     void InputManager::pollEvents() {
-        glfwWaitEventsTimeout(0.1);
-        elapsedTime();
+        double deadline = nextHoldDeadline;
+        if (connectedJoystickBits != 0) deadline = std::min(deadline, lastPollTime + joystickPollInterval.load(std::memory_order::relaxed));
+        double now = glfwGetTime();
+        if (tasks.size_approx() > 0 || deadline <= now) glfwPollEvents();
+        else if (deadline == std::numeric_limits<double>::infinity()) glfwWaitEvents();
+        else glfwWaitEventsTimeout(deadline - now);
+        lastPollTime = glfwGetTime();
+
+        nextHoldDeadline = elapsedTime();
+        // joysticks and windows without callbacks of their own can only be polled
+        pollJoysticks();
+        if (secondaryWindows.size() > 1) dirtyFields |= SecondaryViewportField;
         updateInputState();
     }
 
     void InputManager::runTasks() {
-        std::packaged_task<void()> task;
-        while (tasks.try_dequeue(task)) {
-            task();
+        runTasks(std::numeric_limits<double>::infinity());
+    }
+
+    // Tasks are dequeued a batch at a time, so the queue's synchronization is paid once per batch instead of once
+    // per task; a dequeued batch always runs to completion, the budget can only stop before the next one.
+    void InputManager::runTasks(double maxSeconds) {
+        constexpr size_t TaskBatchSize = 32;
+        InlineFunction<void()> batch[TaskBatchSize];
+        double deadline = glfwGetTime() + maxSeconds;
+        while (size_t count = tasks.try_dequeue_bulk(taskConsumer, batch, TaskBatchSize)) {
+            for (size_t i = 0; i < count; ++i) {
+                batch[i]();
+                batch[i] = nullptr;
+            }
+            if (glfwGetTime() >= deadline) break;
         }
 
         for (auto it : secondaryInputManagers) {
-            it->runTasks();
+            it->runTasks(maxSeconds);
         }
     }
     
     void InputManager::handleEvents() {
-        // TODO: Mouse priority
-
-        static const size_t MAX_EVENT_COUNT_PER_FRAME = 20;
+        handleEvents(EventBudget{});
+    }
 
-        auto tempKeyHandlers = backupContainer(keyHandlers);
-        auto tempUtf8KeyHandlers = backupContainer(utf8KeyHandlers);
+    void InputManager::handleEvents(const EventBudget& budget) {
+        // safe point: registrations and removals made since the last frame take effect here
+        forEachEventRegistry([](auto& registry) { registry.applyPending(); });
+        if (keyHandlers.takeLayoutChange()) rebuildKeyHandlerIndex(keyHandlerIndex, keyHandlers);
+        if (utf8KeyHandlers.takeLayoutChange()) rebuildKeyHandlerIndex(utf8KeyHandlerIndex, utf8KeyHandlers);
 
         // priority decreased -> send artificial release to affected handlers
-        if (previousKeyboardPriority > currentKeyboardPriority) {
-            for (int i = 0; i < keyStates.size(); ++i) {
-                int code = i + 1;
-                auto& prio = keyStates[i];
-                if (prio > currentKeyboardPriority) {
-                    prio = currentKeyboardPriority;
-                    for (auto& h : tempKeyHandlers) {
-                        if (h.isEnabled() && currentKeyboardPriority < h.priority && previousKeyboardPriority >= h.priority)
-                            h.handler(code, Modifier::None, Action::Release);
-                    }
-
-                    if (!tempUtf8KeyHandlers.empty()) {
-                        const char* utf8key = glfwGetKeyName(code, glfwGetKeyScancode(code)); // key, scancode -> name
-                        if (utf8key) {
-                            for (auto& h : tempUtf8KeyHandlers) {
-                                if (h.isEnabled() && currentKeyboardPriority < h.priority && previousKeyboardPriority >= h.priority)
-                                    h.handler(utf8key, Modifier::None, Action::Release);
-                            }
-                        }
-                    }
-                }
-            }
-        }
+        if (previousKeyboardPriority > currentKeyboardPriority) releaseKeysAbovePriority();
         previousKeyboardPriority = currentKeyboardPriority;
+        if (previousMousePriority > currentMousePriority) releaseMouseButtonsAbovePriority();
+        previousMousePriority = currentMousePriority;
 
-        typename decltype(keyEventQueue)::value_type v;
-        int i = 0;
-        while (keyEventQueue.try_dequeue(v)) {
-            for (auto& h : tempKeyHandlers) {
-                int code = h.usesScancode() ? std::get<1>(v) : std::get<0>(v);
-                bool s = std::get<3>(v) == Action::Press || (keyStates[std::get<0>(v) - 1] >= 0 && keyStates[std::get<0>(v) - 1] >= h.priority);
-                if (s && h.isEnabled() && currentKeyboardPriority >= h.priority) 
-                    h.handler(code, std::get<2>(v), std::get<3>(v));
+        auto notify = [](auto& handlers, int currentPriority, auto&&... args) {
+            for (auto& h : handlers) {
+                if (h.isEnabled() && currentPriority >= h.priority)
+                    h.handler(args...);
             }
-        
-            if (!tempUtf8KeyHandlers.empty()) {
-                const char* utf8key = glfwGetKeyName(std::get<0>(v), std::get<1>(v)); // key, scancode -> name
-                if (utf8key) {
-                    for (auto& h : tempUtf8KeyHandlers) {
-                        bool s = std::get<3>(v) == Action::Press || (keyStates[std::get<0>(v) - 1] >= 0 && keyStates[std::get<0>(v) - 1] >= h.priority);
-                        if (s && h.isEnabled() && currentKeyboardPriority >= h.priority) 
-                            h.handler(utf8key, std::get<2>(v), std::get<3>(v));
-                    }
+        };
+
+        // events are dispatched in arrival order, only resizes are collapsed to the last one of the frame
+        // the budget is checked before taking the next event, so an unspent event is never dequeued
+        std::optional<WindowResizeEvent> lastResize;
+        // only frames that coalesced something walk the coalescing handlers again to flush them
+        bool scrolled = false, cursorMoved = false;
+        double deadline = glfwGetTime() + budget.maxSeconds;
+        size_t dispatched = 0;
+        bool budgetSpent = false;
+        InputEvent event;
+        while (true) {
+            if (dispatched == budget.maxEvents || (dispatched > 0 && glfwGetTime() >= deadline)) {
+                budgetSpent = true;
+                break;
+            }
+            if (!events.try_dequeue(event)) break;
+            ++dispatched;
+
+            dispatchedEventTime = event.timestamp;
+            dispatchedEventWindow = event.window;
+            std::visit([&](auto& e) {
+                using T = std::decay_t<decltype(e)>;
+                if constexpr (std::is_same_v<T, KeyEvent>) {
+                    dispatchKeyEvent(e);
+                } else if constexpr (std::is_same_v<T, MouseButtonEvent>) {
+                    dispatchMouseButtonEvent(e);
+                } else if constexpr (std::is_same_v<T, MouseScrollEvent>) {
+                    coalesce(mouseScrollHandlers, e.x, e.y, e.x, e.y);
+                    scrolled = true;
+                } else if constexpr (std::is_same_v<T, CursorMovementEvent>) {
+                    notify(cursorMovementHandlers, currentMousePriority, e.movement);
+                } else if constexpr (std::is_same_v<T, CursorPositionEvent>) {
+                    double dx = lastCursorPosition ? e.x - lastCursorPosition->x : 0;
+                    double dy = lastCursorPosition ? e.y - lastCursorPosition->y : 0;
+                    lastCursorPosition = e;
+                    coalesce(cursorPositionHandlers, e.x, e.y, dx, dy);
+                    cursorMoved = true;
+                } else if constexpr (std::is_same_v<T, WindowResizeEvent>) {
+                    lastResize = e;
+                } else if constexpr (std::is_same_v<T, WindowMoveEvent>) {
+                    notify(windowMoveHandlers, 0, e.x, e.y);
+                } else if constexpr (std::is_same_v<T, CursorHoldEvent>) {
+                    InlineFunction<void(void)> cursorHoldCallback;
+                    if (cursorHoldPayloads.try_dequeue(cursorHoldCallback)) cursorHoldCallback();
+                } else if constexpr (std::is_same_v<T, PathDropEvent>) {
+                    std::vector<std::string> paths;
+                    if (pathDropPayloads.try_dequeue(paths)) notify(pathDropHandlers, 0, paths);
+                } else if constexpr (std::is_same_v<T, MonitorStateChangedEvent>) {
+                    notify(monitorStateChangedHandlers, 0, e.monitor, e.event);
+                } else if constexpr (std::is_same_v<T, TextEvent>) {
+                    notify(textHandlers, currentKeyboardPriority, e.codepoint);
+                } else if constexpr (std::is_same_v<T, WindowFocusEvent>) {
+                    notify(windowFocusHandlers, 0, e.focused);
+                } else if constexpr (std::is_same_v<T, WindowCloseEvent>) {
+                    notify(windowCloseHandlers, 0);
+                } else if constexpr (std::is_same_v<T, JoystickButtonEvent>) {
+                    notify(joystickButtonHandlers, 0, e.joystick, e.button, e.action);
+                } else if constexpr (std::is_same_v<T, JoystickConnectionEvent>) {
+                    notify(joystickConnectionHandlers, 0, e.joystick, e.connected);
+                } else if constexpr (std::is_same_v<T, GamepadButtonEvent>) {
+                    notify(gamepadButtonHandlers, 0, e.joystick, e.button, e.action);
+                } else if constexpr (std::is_same_v<T, GamepadAxisEvent>) {
+                    notify(gamepadAxisHandlers, 0, e.joystick, e.axis, e.value);
                 }
+            }, event.data);
+        }
+        if (lastResize) {
+            notify(windowResizeHandlers, 0, lastResize->width, lastResize->height);
+        }
+        if (cursorMoved) flushCoalesced(cursorPositionHandlers);
+        if (scrolled) flushCoalesced(mouseScrollHandlers);
+        deferredEvents = budgetSpent ? events.size_approx() : 0;
+
+        for (auto it : secondaryInputManagers) {
+            it->handleEvents(budget);
+        }
+    }
+
+    void InputManager::coalesce(HandlerRegistry<CoalescingHandler>& handlers, double x, double y, double dx, double dy) {
+        for (auto& h : handlers) {
+            if (!h.isEnabled() || currentMousePriority < h.priority) continue;
+            switch (h.coalescing) {
+            case Coalescing::All: h.handler(x, y, 1); break;
+            case Coalescing::Last: h.x = x; h.y = y; ++h.samples; break;
+            case Coalescing::Accumulate: h.x += dx; h.y += dy; ++h.samples; break;
             }
+        }
+    }
 
-            if (std::get<3>(v) == Action::Press) keyStates[std::get<0>(v) - 1] = currentKeyboardPriority;
-            else if (std::get<3>(v) == Action::Release) keyStates[std::get<0>(v) - 1] = -1;
+    void InputManager::flushCoalesced(HandlerRegistry<CoalescingHandler>& handlers) {
+        for (auto& h : handlers) {
+            if (h.samples == 0) continue;
+            if (h.isEnabled()) h.handler(h.x, h.y, h.samples);
+            h.x = h.y = 0;
+            h.samples = 0;
+        }
+    }
+
+    // A press records the priority it was delivered under, lowered to the consuming handler's priority, so the
+    // release only reaches handlers that could have seen the press. The scancode and utf8 chains are interleaved by
+    // priority (scancode handlers first on ties), so a consumer only skips the handlers ranked after it in either chain.
+    void InputManager::dispatchKeyEvent(const KeyEvent& e) {
+        // GLFW_KEY_UNKNOWN and other untracked keys get no press bookkeeping
+        bool tracked = e.key >= 0 && e.key < (int)pressedKeyPositions.size();
+        int position = tracked ? pressedKeyPositions[e.key] : -1;
+        int bound = currentKeyboardPriority;
+        // a release or repeat without a recorded press (e.g. pressed before initialize()) goes to the current chain
+        if (tracked && e.action != Action::Press && position >= 0) bound = std::min(pressedKeys[position].priority, bound);
+        int consumedAt = -1;
+
+        // offers the event to the utf8 handlers not offered yet that rank before `below` (all of them if empty)
+        std::optional<int> utf8From;
+        auto offerUtf8 = [&](std::optional<int> below) {
+            if (e.name.id < 0) return false;
+            bool consumed = false;
+            forEachKeyHandler(utf8KeyHandlers, utf8KeyHandlerIndex, e.name.id, e.modifier, e.action, [&](auto& h) {
+                if (below && h.priority >= *below) return true;
+                if ((utf8From && h.priority < *utf8From) || !h.isEnabled() || bound < h.priority) return false;
+                if (!h.handler(e.name.name, e.modifier, e.action)) return false;
+                consumedAt = h.priority;
+                return consumed = true;
+            });
+            utf8From = below;
+            return consumed;
+        };
+
+        bool consumed = forEachKeyHandler(keyHandlers, keyHandlerIndex, e.scancode, e.modifier, e.action, [&](auto& h) {
+            if (!h.isEnabled() || bound < h.priority) return false;
+            if (offerUtf8(h.priority)) return true;
+            if (!h.handler(h.usesScancode() ? e.scancode : e.key, e.modifier, e.action)) return false;
+            consumedAt = h.priority;
+            return true;
+        });
+        if (!consumed) offerUtf8(std::nullopt);
+
+        if (!tracked) return;
+        if (e.action == Action::Press) {
+            PressedKey pressed{e.key, e.scancode, consumedAt >= 0 ? std::min(consumedAt, bound) : bound, e.name};
+            if (position >= 0) {
+                pressedKeys[position] = pressed;
+            } else {
+                pressedKeyPositions[e.key] = (int)pressedKeys.size();
+                pressedKeys.push_back(pressed);
+            }
+        }
+        else if (e.action == Action::Release && position >= 0) {
+            pressedKeyPositions[pressedKeys.back().key] = position;
+            pressedKeys[position] = pressedKeys.back();
+            pressedKeys.pop_back();
+            pressedKeyPositions[e.key] = -1;
+        }
+    }
 
-            i++;
+    void InputManager::dispatchMouseButtonEvent(const MouseButtonEvent& e) {
+        int index = (int)e.button;
+        if (index < 0 || index >= (int)mouseButtonStates.size()) return;
+        int& state = mouseButtonStates[index];
+        int bound = e.action == Action::Press || state < 0 ? currentMousePriority : std::min(state, currentMousePriority);
+        int consumedAt = -1;
+
+        for (auto& h : mouseButtonHandlers) {
+            if (!h.isEnabled() || bound < h.priority) continue;
+            if (h.handler(e.button, e.modifier, e.action)) {
+                consumedAt = h.priority;
+                break;
+            }
         }
 
-        restoreContainer(keyHandlers, tempKeyHandlers);
-        restoreContainer(utf8KeyHandlers, tempUtf8KeyHandlers);
+        if (e.action == Action::Press) state = consumedAt >= 0 ? std::min(consumedAt, bound) : bound;
+        else if (e.action == Action::Release) state = -1;
+    }
 
-        std::function<void(void)> cursorHoldCallback;
-        while (cursorHoldEventCallbackQueue.try_dequeue(cursorHoldCallback)) {
-            cursorHoldCallback();
+    void InputManager::releaseKeysAbovePriority() {
+        for (auto& pressed : pressedKeys) {
+            int pressedAt = pressed.priority;
+            if (pressedAt <= currentKeyboardPriority) continue;
+            pressed.priority = currentKeyboardPriority;
+            auto affected = [&](auto& h) { return h.isEnabled() && currentKeyboardPriority < h.priority && pressedAt >= h.priority; };
+
+            forEachKeyHandler(keyHandlers, keyHandlerIndex, pressed.scancode, Modifier::None, Action::Release, [&](auto& h) {
+                if (affected(h)) h.handler(h.usesScancode() ? pressed.scancode : pressed.key, Modifier::None, Action::Release);
+                return false;
+            });
+
+            // released under the name it was pressed with, even if the layout changed since
+            auto name = pressed.name;
+            if (name.id >= 0) {
+                forEachKeyHandler(utf8KeyHandlers, utf8KeyHandlerIndex, name.id, Modifier::None, Action::Release, [&](auto& h) {
+                    if (affected(h)) h.handler(name.name, Modifier::None, Action::Release);
+                    return false;
+                });
+            }
         }
+    }
 
-        auto handle = [&](auto& queue, auto& handlers, int currentPriority, bool onlyLast) {
-            auto tempHandlers = backupContainer(handlers);
-            typename std::decay_t<decltype(queue)>::value_type v;
-            int i = 0;
-            while (queue.try_dequeue(v)) {
-                i++;
-                if (onlyLast) continue;
-                for (auto& h : tempHandlers) {
-                    if (h.isEnabled() && currentPriority >= h.priority) 
-                        std::apply(h.handler, v);
-                }
+    void InputManager::releaseMouseButtonsAbovePriority() {
+        for (int i = 0; i < (int)mouseButtonStates.size(); ++i) {
+            int pressedAt = mouseButtonStates[i];
+            if (pressedAt <= currentMousePriority) continue;
+            mouseButtonStates[i] = currentMousePriority;
+            for (auto& h : mouseButtonHandlers) {
+                if (h.isEnabled() && currentMousePriority < h.priority && pressedAt >= h.priority)
+                    h.handler((MouseButton)i, Modifier::None, Action::Release);
             }
-            if (onlyLast && i > 0) {
-                for (auto& h : tempHandlers) {
-                    if (h.isEnabled() && currentPriority >= h.priority) 
-                        std::apply(h.handler, v);
+        }
+    }
+
+    template <typename T>
+    void InputManager::pushEvent(GLFWwindow* window, T data) {
+        events.enqueue(InputEvent{glfwGetTime(), window, data});
+    }
+
+    double InputManager::currentEventTime() const {
+        return dispatchedEventTime;
+    }
+
+    GLFWwindow* InputManager::currentEventWindow() const {
+        return dispatchedEventWindow;
+    }
+
+    size_t InputManager::deferredEventCount() const {
+        return deferredEvents;
+    }
+
+    template <typename Handlers>
+    void InputManager::rebuildKeyHandlerIndex(KeyHandlerIndex& index, const Handlers& handlers) {
+        // the per code lists are emptied rather than dropped, so a registration churning one code does not allocate
+        for (auto& [code, positions] : index.byCode) positions.clear();
+        index.catchAll.clear();
+        for (size_t i = 0; i < handlers.size(); ++i) {
+            auto& code = handlers[i].filter.code;
+            if (code) index.byCode[*code].push_back(i);
+            else index.catchAll.push_back(i);
+        }
+    }
+
+    template <typename Handlers, typename F>
+    bool InputManager::forEachKeyHandler(Handlers& handlers, const KeyHandlerIndex& index, int code, Modifier modifier, Action action, F&& f) {
+        static const std::vector<size_t> noHandlers;
+        auto found = index.byCode.find(code);
+        auto& bound = found != index.byCode.end() ? found->second : noHandlers;
+
+        // merge the two sorted position lists so handlers still run in the registry's priority order;
+        // stops at the first handler for which f returns true
+        auto a = index.catchAll.begin(), aEnd = index.catchAll.end();
+        auto b = bound.begin(), bEnd = bound.end();
+        while (a != aEnd || b != bEnd) {
+            size_t i = (b == bEnd || (a != aEnd && *a < *b)) ? *a++ : *b++;
+            auto& h = handlers[i];
+            if (h.filter.matches(modifier, action) && f(h)) return true;
+        }
+        return false;
+    }
+
+    int InputManager::internKeyName(const char* name) {
+        std::lock_guard lock{keyNameMutex};
+        auto found = keyNameIds.find(name);
+        if (found != keyNameIds.end()) return found->second;
+        int id = (int)keyNames.size();
+        keyNames.emplace_back(name);
+        keyNameIds.emplace(keyNames.back(), id);
+        return id;
+    }
+
+    void InputManager::rebuildKeyNameTable() {
+        keyNameTable.assign(GLFW_KEY_LAST + 1, KeyName{-1, nullptr});
+        for (int key = GLFW_KEY_SPACE; key <= GLFW_KEY_LAST; ++key) {
+            const char* name = glfwGetKeyName(key, 0);
+            if (name == nullptr) continue;
+            int id = internKeyName(name);
+            std::lock_guard lock{keyNameMutex};
+            keyNameTable[key] = KeyName{id, keyNames[id].c_str()};
+        }
+    }
+
+    InputManager::KeyName InputManager::keyNameFor(int key, int scancode) {
+        if (key >= 0 && key <= GLFW_KEY_LAST) return keyNameTable[key];
+
+        // keys without a GLFW key code are only known by scancode, these are rare enough to look up each time
+        const char* name = glfwGetKeyName(key, scancode);
+        if (name == nullptr) return KeyName{-1, nullptr};
+        int id = internKeyName(name);
+        std::lock_guard lock{keyNameMutex};
+        return KeyName{id, keyNames[id].c_str()};
+    }
+
+    std::future<void> InputManager::refreshKeyNames() {
+        return executeOn([this](){ rebuildKeyNameTable(); });
+    }
+
+    uint64_t InputManager::holdTicks() {
+        return (uint64_t)(glfwGetTime() * 1000.0);
+    }
+
+    double InputManager::elapsedTime() {
+        uint64_t now = holdTicks();
+        holdHandlers.applyPending();
+        if (holdHandlers.takeLayoutChange()) {
+            ++holdLayoutEpoch;
+            // cursor holds start timing from where the cursor is when they are first seen, key holds on the next press
+            double x, y;
+            glfwGetCursorPos(window, &x, &y);
+            for (size_t i = 0; i < holdHandlers.size(); ++i) {
+                auto& hold = holdHandlers[i].handler;
+                if (hold.started) {
+                    if (holdTimers.cancel(hold.timer)) scheduleHold(i, hold.expiry);
+                    continue;
                 }
+                hold.started = true;
+                if (hold.scancode >= 0) continue;
+                hold.x = x;
+                hold.y = y;
+                scheduleHold(i, now + hold.triggerTicks);
             }
-            restoreContainer(handlers, tempHandlers);
-        };
+        }
+
+        holdTimers.advance(now, [this](uint64_t payload, uint64_t expiry) { fireHold(payload, expiry); });
+        uint64_t next = holdTimers.nextExpiry();
+        return next == std::numeric_limits<uint64_t>::max() ? std::numeric_limits<double>::infinity() : next / 1000.0;
+    }
 
-        handle(mouseButtonEventQueue, mouseButtonHandlers, currentMousePriority, false);
-        handle(mouseScrollEventQueue, mouseScrollHandlers, currentMousePriority, false);
-        handle(cursorMovementEventQueue, cursorMovementHandlers, currentMousePriority, false);
-        handle(cursorPositionEventQueue, cursorPositionHandlers, currentMousePriority, false);
-        handle(windowResizeEventQueue, windowResizeHandlers, 0, true);
-        handle(windowMoveEventQueue, windowMoveHandlers, 0, false);
-        handle(windowFocusEventQueue, windowFocusHandlers, 0, false);
-        handle(windowCloseEventQueue, windowCloseHandlers, 0, false);
-        handle(pathDropEventQueue, pathDropHandlers, 0, false);
-        handle(monitorStateChangedEventQueue, monitorStateChangedHandlers, 0, false);
-        handle(textEventQueue, textHandlers, currentKeyboardPriority, false);
+    void InputManager::scheduleHold(size_t position, uint64_t expiry) {
+        auto& hold = holdHandlers[position].handler;
+        hold.expiry = expiry;
+        hold.timer = holdTimers.schedule(expiry, (uint64_t)holdLayoutEpoch << 32 | position);
+    }
 
-        for (auto it : secondaryInputManagers) {
-            it->handleEvents();
+    void InputManager::fireHold(uint64_t payload, uint64_t expiry) {
+        // scheduled before holders last moved: the live ones were rescheduled, this one belonged to a removed holder
+        if ((uint32_t)(payload >> 32) != holdLayoutEpoch) return;
+        size_t position = (uint32_t)payload;
+        auto& holder = holdHandlers[position];
+        auto& hold = holder.handler;
+        if (hold.repeatTicks > 0) scheduleHold(position, std::max(expiry + hold.repeatTicks, holdTimers.now() + 1));
+        if (!holder.isEnabled()) return;
+        cursorHoldPayloads.enqueue([h = hold.handler, x = hold.x, y = hold.y](){ (*h)(x, y); });
+        pushEvent(window, CursorHoldEvent{});
+    }
+
+    // a cursor hold restarts only when the cursor leaves its threshold, so a still cursor fires it once
+    void InputManager::restartCursorHolds(double x, double y) {
+        uint64_t now = 0;
+        for (size_t i = 0; i < holdHandlers.size(); ++i) {
+            auto& hold = holdHandlers[i].handler;
+            if (!hold.started || hold.scancode >= 0) continue;
+            double dx = x - hold.x, dy = y - hold.y;
+            if (dx * dx + dy * dy <= hold.threshold2) continue;
+            if (now == 0) now = holdTicks();
+            hold.x = x;
+            hold.y = y;
+            holdTimers.cancel(hold.timer);
+            scheduleHold(i, now + hold.triggerTicks);
+        }
+    }
+
+    void InputManager::restartKeyHolds(int scancode, int action) {
+        if (action == GLFW_REPEAT) return;
+        uint64_t now = holdTicks();
+        for (size_t i = 0; i < holdHandlers.size(); ++i) {
+            auto& hold = holdHandlers[i].handler;
+            if (!hold.started || hold.scancode != scancode) continue;
+            holdTimers.cancel(hold.timer);
+            if (action == GLFW_PRESS) scheduleHold(i, now + hold.triggerTicks);
+        }
+    }
+
+    void InputManager::wakePollThread() {
+        glfwPostEmptyEvent();
+    }
+
+    void InputManager::setJoystickPollInterval(double seconds) {
+        joystickPollInterval.store(seconds, std::memory_order::relaxed);
+    }
+
+    void InputManager::fillInputState(PerFrameGlobalInputData* data) {
+        *data = {};
+        refreshInputState(data, AllFields);
+    }
+
+    // Edges are accumulated per transition rather than derived from the down bits, which cannot show a tap or a
+    // release and press again between two snapshots.
+    void InputManager::updateButtonBits(uint64_t& down, uint64_t& pressedSince, uint64_t& releasedSince, int bit, int action) {
+        uint64_t mask = uint64_t{1} << bit;
+        if (action == GLFW_PRESS) {
+            down |= mask;
+            pressedSince |= mask;
+        } else if (action == GLFW_RELEASE) {
+            down &= ~mask;
+            releasedSince |= mask;
+        }
+    }
+
+    // Turns the edges since the last publish into the delta of the snapshot about to be published and forgets the
+    // deltas the frame consumer is done with.
+    void InputManager::advanceEdges(uint64_t sequence) {
+        uint64_t consumed = consumedEdgeSequence.load(std::memory_order::relaxed);
+        int seen = 0;
+        while (seen < edgeDeltaCount && edgeDeltas[seen].sequence < consumed) ++seen;
+        std::move(edgeDeltas.begin() + seen, edgeDeltas.begin() + edgeDeltaCount, edgeDeltas.begin());
+        edgeDeltaCount -= seen;
+
+        EdgeDelta delta;
+        delta.sequence = sequence;
+        uint64_t any = (delta.mouseButtonPressed = std::exchange(mouseButtonPressedBits, 0))
+            | (delta.mouseButtonReleased = std::exchange(mouseButtonReleasedBits, 0));
+        for (int i = 0; i < PerFrameGlobalInputData::KeyBitWords; ++i) {
+            any |= (delta.keyPressed[i] = std::exchange(keyPressedBits[i], 0))
+                | (delta.keyReleased[i] = std::exchange(keyReleasedBits[i], 0));
+        }
+        if (any == 0) return;
+        if (edgeDeltaCount == (int)edgeDeltas.size()) {
+            edgeDeltas[1].merge(edgeDeltas[0]);
+            std::move(edgeDeltas.begin() + 1, edgeDeltas.end(), edgeDeltas.begin());
+            --edgeDeltaCount;
         }
+        edgeDeltas[edgeDeltaCount++] = delta;
     }
 
-    void InputManager::elapsedTime() {
-        // TODO: cursorhold nal igy nem jo a backupcontainer es megoldas, mert ket szalbol van hasznalva
-        auto tempHandlers = backupContainer(cursorHoldHandlers);
+    void InputManager::writeEdges(PerFrameGlobalInputData* data) const {
+        EdgeDelta edges;
+        for (int i = 0; i < PerFrameGlobalInputData::KeyBitWords; ++i) {
+            edges.keyPressed[i] = keyPressedBits[i];
+            edges.keyReleased[i] = keyReleasedBits[i];
+        }
+        edges.mouseButtonPressed = mouseButtonPressedBits;
+        edges.mouseButtonReleased = mouseButtonReleasedBits;
+        for (int i = 0; i < edgeDeltaCount; ++i) {
+            edges.merge(edgeDeltas[i]);
+        }
+        std::memcpy(data->keyPressed, edges.keyPressed, sizeof(edges.keyPressed));
+        std::memcpy(data->keyReleased, edges.keyReleased, sizeof(edges.keyReleased));
+        data->mouseButtonPressed = edges.mouseButtonPressed;
+        data->mouseButtonReleased = edges.mouseButtonReleased;
+    }
 
-        double x, y;
-        glfwGetCursorPos(window, &x, &y);
-        for (auto& it : tempHandlers) {
-            if (!it.isEnabled()) continue;
+    void InputManager::refreshInputState(PerFrameGlobalInputData* data, unsigned fields) {
+        if (fields & MouseButtonField) {
+            for (int i = 0; i < 5; ++i) {
+                data->mouseButton[i] = glfwGetMouseButton(window, i);
+            }
+            data->mouseButtonDown = mouseButtonDownBits;
+        }
+        if (fields & KeyboardField) {
+            std::memcpy(data->keyDown, keyDownBits, sizeof(keyDownBits));
+        }
+        if (fields & (KeyboardField | MouseButtonField)) {
+            writeEdges(data);
+        }
+        if (fields & CursorModeField) {
+            data->inputModeCursor = glfwGetInputMode(window, GLFW_CURSOR);
+        }
+        if (fields & JoystickField) {
+            data->connectedJoysticks = connectedJoystickBits;
+            for (int jid = 0; jid < PerFrameGlobalInputData::MaxJoysticks; ++jid) {
+                if ((connectedJoystickBits >> jid) & 1) data->joysticks[jid] = joystickStates[jid];
+                else if (data->joysticks[jid].connected) data->joysticks[jid] = PerFrameJoystickData{};
+            }
+        }
+        if (fields & MonitorField) {
+            rebuildMonitorTopology();
+            data->monitorTopologyVersion = monitorTopologyVersion;
+        }
+        if (fields & WindowSizeField) {
+            glfwGetWindowSize(window, &data->w, &data->h);
+            glfwGetFramebufferSize(window, &data->displayW, &data->displayH);
+        }
 
-            if (it.handler.startTime < 0) {
-                it.handler.startTime = glfwGetTime() * 1000.0;
-                it.handler.x = x;
-                it.handler.y = y;
-                continue;
+        if (fields & SecondaryViewportField) {
+            data->viewportCount = std::min((int)secondaryWindows.size(), PerFrameGlobalInputData::MaxViewports);
+            for (int i = 0; i < data->viewportCount; ++i) {
+                fillViewportData(secondaryWindows[i], data->viewportData[i]);
+            }
+        } else if (fields & MainViewportField) {
+            auto found = data->findViewport(window);
+            if (found != nullptr) {
+                fillViewportData(window, *found);
             }
+        }
+
+        data->timestamp = glfwGetTime();
+    }
+
+    void InputManager::setJoystickConnected(int jid, bool connected) {
+        if (jid < 0 || jid >= PerFrameGlobalInputData::MaxJoysticks) return;
+        auto& js = joystickStates[jid];
+        // buttons still held by a vanishing joystick get their release
+        for (int i = 0; i < js.buttonCount; ++i) {
+            if (js.buttons[i] == GLFW_PRESS) pushEvent(nullptr, JoystickButtonEvent{jid, i, Action::Release});
+        }
+        if (js.isGamepad) diffGamepadState(jid, js.gamepadState, GamepadRestState);
+        js = PerFrameJoystickData{};
+        js.gamepadState = GamepadRestState;
+        std::copy_n(GamepadRestState.axes, 6, reportedGamepadAxes[jid].begin());
+        if (connected) {
+            js.connected = 1;
+            js.isGamepad = glfwJoystickIsGamepad(jid);
+            connectedJoystickBits |= 1u << jid;
+        } else {
+            connectedJoystickBits &= ~(1u << jid);
+        }
+        pushEvent(nullptr, JoystickConnectionEvent{jid, connected});
+        dirtyFields |= JoystickField;
+    }
+
+    void InputManager::claimJoysticks() {
+        joystickOwner = this;
+        for (int jid = 0; jid < PerFrameGlobalInputData::MaxJoysticks; ++jid) {
+            if (glfwJoystickPresent(jid)) setJoystickConnected(jid, true);
+        }
+    }
+
+    // the joysticks disconnect from this manager's point of view, with releases for held buttons
+    void InputManager::releaseJoysticks() {
+        if (joystickOwner != this) return;
+        joystickOwner = nullptr;
+        for (int jid = 0; jid < PerFrameGlobalInputData::MaxJoysticks; ++jid) {
+            if ((connectedJoystickBits >> jid) & 1) setJoystickConnected(jid, false);
+        }
+    }
 
-            double dx = x - it.handler.x, dy = y - it.handler.y;
-            double dv2 = dx * dx + dy * dy;
-            if (dv2 <= it.handler.threshold2) {
-                double elapsedTime = glfwGetTime() * 1000.0 - it.handler.startTime;
-                if (elapsedTime >= it.handler.timeToTrigger) {
-                    cursorHoldEventCallbackQueue.emplace(std::bind_front(it.handler.handler, it.handler.x, it.handler.y));
+    // buttons are diffed against the previous poll here, so button changes reach handlers as events
+    void InputManager::pollJoysticks() {
+        if (connectedJoystickBits == 0) return;
+        for (int jid = 0; jid < PerFrameGlobalInputData::MaxJoysticks; ++jid) {
+            if (!((connectedJoystickBits >> jid) & 1)) continue;
+            auto& js = joystickStates[jid];
+
+            int axes_c = 0, buttons_c = 0;
+            const float* axes = glfwGetJoystickAxes(jid, &axes_c);
+            js.axisCount = axes ? std::min(axes_c, PerFrameJoystickData::MaxAxes) : 0;
+            std::copy_n(axes, js.axisCount, js.axes);
+            processAxes(axisProcessing[jid], js.axes, js.axisCount, js.processedAxes);
+
+            const unsigned char* buttons = glfwGetJoystickButtons(jid, &buttons_c);
+            int buttonCount = buttons ? std::min(buttons_c, PerFrameJoystickData::MaxButtons) : 0;
+            for (int i = 0; i < buttonCount; ++i) {
+                unsigned char previous = i < js.buttonCount ? js.buttons[i] : GLFW_RELEASE;
+                if (buttons[i] != previous) pushEvent(nullptr, JoystickButtonEvent{jid, i, buttons[i] == GLFW_PRESS ? Action::Press : Action::Release});
+            }
+            std::copy_n(buttons, buttonCount, js.buttons);
+            js.buttonCount = buttonCount;
+
+            if (js.isGamepad) {
+                GLFWgamepadstate gamepadState;
+                if (glfwGetGamepadState(jid, &gamepadState)) {
+                    GamepadState current;
+                    std::memcpy(current.buttons, gamepadState.buttons, sizeof(current.buttons));
+                    std::memcpy(current.axes, gamepadState.axes, sizeof(current.axes));
+                    diffGamepadState(jid, js.gamepadState, current);
+                    js.gamepadState = current;
                 }
-            } else {
-                it.handler.startTime = glfwGetTime() * 1000.0;
-                it.handler.x = x;
-                it.handler.y = y;
             }
         }
+        dirtyFields |= JoystickField;
+    }
 
-        restoreContainer(cursorHoldHandlers, tempHandlers);
+    void InputManager::diffGamepadState(int jid, const GamepadState& previous, const GamepadState& current) {
+        for (int i = 0; i < 15; ++i) {
+            if (current.buttons[i] != previous.buttons[i])
+                pushEvent(nullptr, GamepadButtonEvent{jid, GamepadButton{i}, current.buttons[i] == GLFW_PRESS ? Action::Press : Action::Release});
+        }
+        auto& reported = reportedGamepadAxes[jid];
+        for (int i = 0; i < 6; ++i) {
+            if (std::abs(current.axes[i] - reported[i]) < gamepadAxisThresholds[i].load(std::memory_order::relaxed)) continue;
+            reported[i] = current.axes[i];
+            pushEvent(nullptr, GamepadAxisEvent{jid, GamepadAxis{i}, current.axes[i]});
+        }
     }
 
-    void InputManager::fillInputState(PerFrameGlobalInputData* data) {
-        *data = {};
-        auto clipBoardStr = glfwGetClipboardString(window);
-        data->clipBoardString = clipBoardStr == nullptr ? "" : clipBoardStr;
-        for (int i = 0; i < 5; ++i) {
-            data->mouseButton[i] = glfwGetMouseButton(window, i);
+    // Every pass runs over all MaxAxes lanes without data dependent branches, so each one vectorizes; lanes past
+    // count are zeroed. processed holds the previous output on entry, which smoothing filters against.
+    void InputManager::processAxes(const AxisProcessing& p, const float* raw, int count, float* processed) {
+        constexpr int N = PerFrameJoystickData::MaxAxes;
+        float x[N], magnitude[N];
+
+        for (int i = 0; i < N; ++i) {
+            float value = i < count ? raw[i] : 0.0f;
+            x[i] = std::clamp((value - p.center[i]) / p.range[i], -1.0f, 1.0f);
+        }
+
+        // an unpaired axis contributes 0 as its partner, which leaves its own |x|
+        for (int i = 0; i < N; ++i) {
+            int partner = p.partner[i];
+            float other = partner >= 0 && partner < N ? x[partner] : 0.0f;
+            magnitude[i] = std::min(std::sqrt(x[i] * x[i] + other * other), 1.0f);
         }
-        data->inputModeCursor = glfwGetInputMode(window, GLFW_CURSOR);
-        int axes_c, buttons_c;
-        const float* axes = glfwGetJoystickAxes(GLFW_JOYSTICK_1, &axes_c);
-        for (int i = 0; i < axes_c; ++i) {
-            data->joystickAxes.push_back(axes[i]);
+
+        float live = std::max(1.0f - p.deadzone, 1e-6f);
+        for (int i = 0; i < N; ++i) {
+            // magnitude past the deadzone rescaled to 0..1, then through the curve
+            float m = std::max(magnitude[i] - p.deadzone, 0.0f) / live;
+            float position = m * (AxisProcessing::CurveSize - 1);
+            int index = std::min((int)position, AxisProcessing::CurveSize - 2);
+            float shaped = p.curve[index] + (p.curve[index + 1] - p.curve[index]) * (position - index);
+            float scale = magnitude[i] > 0.0f ? shaped / magnitude[i] : 0.0f;
+            x[i] *= scale;
         }
-        const unsigned char* buttons = glfwGetJoystickButtons(GLFW_JOYSTICK_1, &buttons_c);
-        for (int i = 0; i < buttons_c; ++i) {
-            data->joystickButtons.push_back(buttons[i]);
+
+        float keep = p.smoothing;
+        for (int i = 0; i < N; ++i) {
+            float value = processed[i] * keep + x[i] * (1.0f - keep);
+            processed[i] = i < count ? value : 0.0f;
         }
-        data->gamepadStateErrorCode = glfwGetGamepadState(GLFW_JOYSTICK_1, data->gamepadState.get());
+    }
+
+    std::future<void> InputManager::setAxisProcessing(int joystick, const AxisProcessing& processing) {
+        return executeOn([this, joystick, processing](){
+            if (joystick >= 0 && joystick < PerFrameGlobalInputData::MaxJoysticks) axisProcessing[joystick] = processing;
+        });
+    }
+
+    void InputManager::setGamepadAxisThreshold(GamepadAxis axis, float threshold) {
+        gamepadAxisThresholds[(int)axis].store(threshold, std::memory_order::relaxed);
+    }
+
+    void InputManager::rebuildMonitorTopology() {
+        auto topology = std::make_shared<MonitorTopology>();
         int monitor_c;
         GLFWmonitor** monitors = glfwGetMonitors(&monitor_c);
-        for (int i = 0; i < monitor_c; ++i) {
-            PerFrameMonitorData mData = {};
-            mData.videoMode = std::make_unique<GLFWvidmode>(*glfwGetVideoMode(monitors[i]));
+        topology->monitorCount = std::min(monitor_c, MonitorTopology::MaxMonitors);
+        for (int i = 0; i < topology->monitorCount; ++i) {
+            auto& mData = topology->monitors[i];
+            mData.monitor = monitors[i];
+            const GLFWvidmode* mode = glfwGetVideoMode(monitors[i]);
+            mData.videoMode = VideoMode{ mode->width, mode->height, mode->redBits, mode->greenBits, mode->blueBits, mode->refreshRate };
             glfwGetMonitorPos(monitors[i], &mData.posX, &mData.posY);
             glfwGetMonitorWorkarea(monitors[i], &mData.workAreaX, &mData.workAreaY, &mData.workAreaW, &mData.workAreaH);
             glfwGetMonitorContentScale(monitors[i], &mData.scaleX, &mData.scaleY);
-            data->monitors.push_back(std::move(mData));
         }
-        glfwGetWindowSize(window, &data->w, &data->h);
-        glfwGetFramebufferSize(window, &data->displayW, &data->displayH);
+        topology->version = ++monitorTopologyVersion;
+        monitorTopology.store(std::move(topology));
+    }
 
-        for (auto w : secondaryWindows) {
-            PerFramePerViewportData vData;
-            vData.focused = glfwGetWindowAttrib(w, GLFW_FOCUSED);
-            vData.hovered = glfwGetWindowAttrib(w, GLFW_HOVERED);
-            vData.iconified = glfwGetWindowAttrib(w, GLFW_ICONIFIED);
-            glfwGetCursorPos(w, &vData.cursorX, &vData.cursorY);
-            for (int i = 0; i < 5; ++i) {
-                vData.mouseButton[i] = glfwGetMouseButton(w, i);
+    std::shared_ptr<const MonitorTopology> InputManager::getMonitorTopology() const {
+        return monitorTopology.load();
+    }
+
+    void InputManager::fillViewportData(GLFWwindow* w, PerFramePerViewportData& vData) {
+        vData.window = w;
+        vData.focused = glfwGetWindowAttrib(w, GLFW_FOCUSED);
+        vData.hovered = glfwGetWindowAttrib(w, GLFW_HOVERED);
+        vData.iconified = glfwGetWindowAttrib(w, GLFW_ICONIFIED);
+        glfwGetCursorPos(w, &vData.cursorX, &vData.cursorY);
+        for (int i = 0; i < 5; ++i) {
+            vData.mouseButton[i] = glfwGetMouseButton(w, i);
+        }
+        glfwGetWindowPos(w, &vData.posX, &vData.posY);
+        glfwGetWindowSize(w, &vData.width, &vData.height);
+    }
+
+    void InputManager::updateInputState() {
+        // the frame consumer moved past the oldest edges, republish without them
+        if (edgeDeltaCount > 0 && edgeDeltas[0].sequence < consumedEdgeSequence.load(std::memory_order::relaxed)) {
+            dirtyFields |= KeyboardField | MouseButtonField;
+        }
+        if (dirtyFields == 0) return;
+
+        int published = publishedSnapshot.load(std::memory_order::relaxed);
+        int target = -1;
+        for (int i = 0; i < (int)snapshots.size(); ++i) {
+            if (i != published && snapshots[i].readers.load() == 0) {
+                target = i;
+                break;
             }
-            glfwGetWindowPos(w, &vData.posX, &vData.posY);
-            glfwGetWindowSize(w, &vData.width, &vData.height);
-            data->viewportData.insert(std::make_pair(w, std::move(vData)));
         }
+        // every spare slot is still being read: keep the dirty fields and publish on the next update instead of waiting
+        if (target < 0) return;
+
+        // carry the unchanged fields over from the published snapshot, then requery only what went stale
+        auto& data = snapshots[target].data;
+        data = snapshots[published].data;
+        data.sequence = historyCount.load(std::memory_order::relaxed);
+        if (dirtyFields & (KeyboardField | MouseButtonField)) advanceEdges(data.sequence);
+        refreshInputState(&data, dirtyFields);
+        dirtyFields = 0;
+        publishedSnapshot.store(target);
+        recordHistory(data);
+    }
 
-        data->timestamp = glfwGetTime();
+    const PerFrameGlobalInputData* InputManager::acquireSnapshot() {
+        while (true) {
+            int index = publishedSnapshot.load();
+            auto& slot = snapshots[index];
+            slot.readers.fetch_add(1);
+            // the slot may have been retired and handed to the writer before our reader count became visible
+            if (publishedSnapshot.load() == index) return &slot.data;
+            slot.readers.fetch_sub(1);
+        }
     }
 
-    void InputManager::updateInputState() {
-        fillInputState(previousState);
-        previousState = globalInputState.exchange(previousState, std::memory_order::release);
+    void InputManager::releaseSnapshot(const PerFrameGlobalInputData* snapshot) {
+        for (auto& slot : snapshots) {
+            if (&slot.data == snapshot) {
+                slot.readers.fetch_sub(1);
+                return;
+            }
+        }
+        assert(false);
+    }
+
+    void InputManager::consumeEdges(const PerFrameGlobalInputData* snapshot) {
+        uint64_t next = snapshot->sequence + 1;
+        uint64_t consumed = consumedEdgeSequence.load();
+        while (consumed < next && !consumedEdgeSequence.compare_exchange_weak(consumed, next)) {}
+    }
+
+    void InputManager::recordHistory(const PerFrameGlobalInputData& data) {
+        uint64_t index = historyCount.load(std::memory_order::relaxed);
+        auto& entry = history[index % history.size()];
+        entry.sequence.store(2 * index + 1, std::memory_order::relaxed);
+        std::atomic_thread_fence(std::memory_order::release);
+        std::memcpy(&entry.data, &data, sizeof(data));
+        entry.sequence.store(2 * index + 2, std::memory_order::release);
+        historyCount.store(index + 1, std::memory_order::release);
+    }
+
+    // both fail when the entry was overwritten by a newer snapshot while being read
+    bool InputManager::readHistory(uint64_t index, PerFrameGlobalInputData* data) const {
+        auto& entry = history[index % history.size()];
+        if (entry.sequence.load(std::memory_order::acquire) != 2 * index + 2) return false;
+        std::memcpy(data, &entry.data, sizeof(*data));
+        std::atomic_thread_fence(std::memory_order::acquire);
+        return entry.sequence.load(std::memory_order::relaxed) == 2 * index + 2;
+    }
+
+    bool InputManager::readHistoryTime(uint64_t index, double* timestamp) const {
+        auto& entry = history[index % history.size()];
+        if (entry.sequence.load(std::memory_order::acquire) != 2 * index + 2) return false;
+        std::memcpy(timestamp, &entry.data.timestamp, sizeof(*timestamp));
+        std::atomic_thread_fence(std::memory_order::acquire);
+        return entry.sequence.load(std::memory_order::relaxed) == 2 * index + 2;
+    }
+
+    bool InputManager::stateAt(double timestamp, PerFrameGlobalInputData* data) const {
+        while (true) {
+            uint64_t count = historyCount.load(std::memory_order::acquire);
+            if (count == 0) return false;
+            uint64_t oldest = count > history.size() ? count - history.size() : 0;
+
+            // binary search for the last snapshot taken at or before timestamp, timestamps only grow
+            uint64_t lo = oldest, hi = count;
+            double time;
+            bool torn = false;
+            while (lo < hi) {
+                uint64_t mid = lo + (hi - lo) / 2;
+                if (!readHistoryTime(mid, &time)) { torn = true; break; }
+                if (time <= timestamp) lo = mid + 1;
+                else hi = mid;
+            }
+            if (torn) continue;
+            if (lo == oldest) return false;
+
+            uint64_t before = lo - 1;
+            if (!readHistory(before, data)) continue;
+            if (lo == count) return true;
+
+            PerFrameGlobalInputData after;
+            if (!readHistory(lo, &after)) continue;
+
+            double t = (timestamp - data->timestamp) / (after.timestamp - data->timestamp);
+            auto lerp = [t](auto a, auto b) { return a + (b - a) * t; };
+            for (int jid = 0; jid < PerFrameGlobalInputData::MaxJoysticks; ++jid) {
+                auto& js = data->joysticks[jid];
+                auto& next = after.joysticks[jid];
+                if (!js.connected || !next.connected) continue;
+                for (int i = 0; i < std::min(js.axisCount, next.axisCount); ++i) {
+                    js.axes[i] = (float)lerp(js.axes[i], next.axes[i]);
+                    js.processedAxes[i] = (float)lerp(js.processedAxes[i], next.processedAxes[i]);
+                }
+                for (int i = 0; i < 6; ++i) {
+                    js.gamepadState.axes[i] = (float)lerp(js.gamepadState.axes[i], next.gamepadState.axes[i]);
+                }
+            }
+            for (int i = 0; i < data->viewportCount; ++i) {
+                auto& viewport = data->viewportData[i];
+                auto next = after.findViewport(viewport.window);
+                if (next == nullptr) continue;
+                viewport.cursorX = lerp(viewport.cursorX, next->cursorX);
+                viewport.cursorY = lerp(viewport.cursorY, next->cursorY);
+            }
+            data->timestamp = timestamp;
+            return true;
+        }
+    }
+
+    std::string InputManager::getClipboardString() {
+        if (clipboardStale.load()) {
+            if (std::this_thread::get_id() == mainThreadId) {
+                fetchClipboardString();
+            } else if (!clipboardFetchQueued.exchange(true)) {
+                post([this](){
+                    clipboardFetchQueued.store(false);
+                    fetchClipboardString();
+                });
+            }
+        }
+        std::lock_guard lock{clipboardMutex};
+        return clipboardString;
+    }
+
+    std::future<void> InputManager::requestClipboardString() {
+        clipboardStale.store(true);
+        return executeOn([this](){ fetchClipboardString(); });
+    }
+
+    void InputManager::setClipboardString(std::string text) {
+        {
+            std::lock_guard lock{clipboardMutex};
+            clipboardString = text;
+        }
+        post([this, t = std::move(text)](){
+            glfwSetClipboardString(window, t.c_str());
+        });
+    }
+
+    void InputManager::fetchClipboardString() {
+        // cleared before the query so an invalidation racing with it is not lost
+        clipboardStale.store(false);
+        auto clipBoardStr = glfwGetClipboardString(window);
+        std::lock_guard lock{clipboardMutex};
+        clipboardString = clipBoardStr == nullptr ? "" : clipBoardStr;
     }
 
     void InputManager::registerWindow(GLFWwindow* window) {
         secondaryWindows.push_back(window);
+        dirtyFields |= SecondaryViewportField;
     }
 
     void InputManager::removeRegisteredWindow(GLFWwindow* window) {
         auto found = std::find(secondaryWindows.begin(), secondaryWindows.end(), window);
         assert(found != secondaryWindows.end());
         secondaryWindows.erase(found);
+        dirtyFields |= SecondaryViewportField;
     }
 
     void InputManager::registerInputManager(InputManager* inputManager) {
         secondaryInputManagers.push_back(inputManager);
+        // a secondary initialized before its primary hands the joysticks over
+        if (joystickOwner == inputManager) {
+            inputManager->releaseJoysticks();
+            claimJoysticks();
+        }
     }
 
     void InputManager::removeRegisteredInputManager(InputManager* inputManager) {
@@ -371,94 +1069,109 @@ namespace glfwim {
         defaultPriority = priority;
     }
 
-    InputManager::CallbackHandler InputManager::registerKeyHandlerWithKey(std::function<void(int, Modifier, Action)> handler) {
-        keyHandlers.emplace_back(std::move(handler), false, defaultPriority);
-        return CallbackHandler{ this, CallbackType::Key, keyHandlers.size() - 1 };
+    InputManager::CallbackHandler InputManager::registerKeyHandler_impl(InlineFunction<bool(int, Modifier, Action)> handler, bool useScancode, KeyFilter filter) {
+        return CallbackHandler{ this, CallbackType::Key, keyHandlers.add(std::move(handler), useScancode, filter, defaultPriority) };
     }
 
-    InputManager::CallbackHandler InputManager::registerKeyHandler(std::function<void(int, Modifier, Action)> handler) {
-        keyHandlers.emplace_back(std::move(handler), true, defaultPriority);
-        return CallbackHandler{ this, CallbackType::Key, keyHandlers.size() - 1 };
+    InputManager::CallbackHandler InputManager::registerUtf8KeyHandler_impl(InlineFunction<bool(const char*, Modifier, Action)> handler, KeyFilter filter) {
+        return CallbackHandler{ this, CallbackType::Utf8Key, utf8KeyHandlers.add(std::move(handler), false, filter, defaultPriority) };
     }
 
-    InputManager::CallbackHandler InputManager::registerUtf8KeyHandler(std::function<void(const char*, Modifier, Action)> handler) {
-        utf8KeyHandlers.emplace_back(std::move(handler), defaultPriority);
-        return CallbackHandler{this, CallbackType::Utf8Key, utf8KeyHandlers.size() - 1};
+    InputManager::CallbackHandler InputManager::registerMouseButtonHandler_impl(InlineFunction<bool(MouseButton, Modifier, Action)> handler) {
+        return CallbackHandler{ this, CallbackType::MouseButton, mouseButtonHandlers.add(std::move(handler), defaultPriority) };
     }
 
-    InputManager::CallbackHandler InputManager::registerMouseButtonHandler(std::function<void(MouseButton, Modifier, Action)> handler) {
-        mouseButtonHandlers.emplace_back(std::move(handler), defaultPriority);
-        return CallbackHandler{this, CallbackType::MouseButton, mouseButtonHandlers.size() - 1};
+    InputManager::CallbackHandler InputManager::registerMouseScrollHandler(Coalescing coalescing, InlineFunction<void(double, double, int)> handler) {
+        return CallbackHandler{ this, CallbackType::MouseScroll, mouseScrollHandlers.add(std::move(handler), coalescing, defaultPriority) };
     }
 
-    InputManager::CallbackHandler InputManager::registerMouseScrollHandler(std::function<void(double, double)> handler) {
-        mouseScrollHandlers.emplace_back(std::move(handler), defaultPriority);
-        return CallbackHandler{this, CallbackType::MouseScroll, mouseScrollHandlers.size() - 1};
+    InputManager::CallbackHandler InputManager::registerCursorMovementHandler(InlineFunction<void(CursorMovement)> handler) {
+        return CallbackHandler{ this, CallbackType::CursorMovement, cursorMovementHandlers.add(std::move(handler), defaultPriority) };
     }
 
-    InputManager::CallbackHandler InputManager::registerCursorMovementHandler(std::function<void(CursorMovement)> handler) {
-        cursorMovementHandlers.emplace_back(std::move(handler), defaultPriority);
-        return CallbackHandler{this, CallbackType::CursorMovement, cursorMovementHandlers.size() - 1};
+    InputManager::CallbackHandler InputManager::registerCursorPositionHandler(Coalescing coalescing, InlineFunction<void(double, double, int)> handler) {
+        return CallbackHandler{ this, CallbackType::CursorPosition, cursorPositionHandlers.add(std::move(handler), coalescing, defaultPriority) };
     }
 
-    InputManager::CallbackHandler InputManager::registerCursorPositionHandler(std::function<void(double, double)> handler) {
-        cursorPositionHandlers.emplace_back(std::move(handler), defaultPriority);
-        return CallbackHandler{this, CallbackType::CursorPosition, cursorPositionHandlers.size() - 1};
+    InputManager::CallbackHandler InputManager::registerCursorHoldHandler(double triggerTimeInMs, double threshold, InlineFunction<void(double, double)> handler) {
+        return registerHoldHandler_impl(CallbackType::CursorHold, -1, triggerTimeInMs, threshold, 0.0, std::move(handler));
     }
 
-    InputManager::CallbackHandler InputManager::registerCursorHoldHandler(double triggerTimeInMs, double threshold, std::function<void(double, double)> handler) {
-        CursorHoldData data;
-        data.handler = std::move(handler);
-        data.threshold2 = threshold * threshold;
-        data.timeToTrigger = triggerTimeInMs;
+    InputManager::CallbackHandler InputManager::registerCursorHoldHandler(double triggerTimeInMs, double threshold, double repeatIntervalInMs, InlineFunction<void(double, double)> handler) {
+        return registerHoldHandler_impl(CallbackType::CursorHold, -1, triggerTimeInMs, threshold, repeatIntervalInMs, std::move(handler));
+    }
+
+    InputManager::CallbackHandler InputManager::registerHoldHandler_impl(CallbackType type, int scancode, double triggerTimeInMs, double threshold, double repeatIntervalInMs, InlineFunction<void(double, double)> handler) {
+        HoldData data;
+        data.handler = std::make_shared<InlineFunction<void(double, double)>>(std::move(handler));
+        data.scancode = scancode;
         data.x = data.y = 0;
-        data.startTime = -1;
-        cursorHoldHandlers.emplace_back(std::move(data), defaultPriority);
-        return CallbackHandler{this, CallbackType::CursorHold, cursorHoldHandlers.size() - 1};
+        data.threshold2 = threshold * threshold;
+        data.triggerTicks = (uint64_t)std::ceil(std::max(triggerTimeInMs, 0.0));
+        // a repeating timer always moves forward by at least a tick
+        data.repeatTicks = repeatIntervalInMs > 0 ? std::max<uint64_t>((uint64_t)std::ceil(repeatIntervalInMs), 1) : 0;
+        data.started = false;
+        data.expiry = 0;
+        auto id = holdHandlers.add(std::move(data), defaultPriority);
+        // its timer starts with the next poll, which may otherwise sleep until the next event
+        wakePollThread();
+        return CallbackHandler{ this, type, id };
+    }
+
+    InputManager::CallbackHandler InputManager::registerWindowResizeHandler(InlineFunction<void(int, int)> handler) {
+        return CallbackHandler{ this, CallbackType::WindowResize, windowResizeHandlers.add(std::move(handler), 0) };
+    }
+
+    InputManager::CallbackHandler InputManager::registerWindowMoveHandler(InlineFunction<void(int, int)> handler) {
+        return CallbackHandler{ this, CallbackType::WindowMove, windowMoveHandlers.add(std::move(handler), 0) };
+    }
+
+    InputManager::CallbackHandler InputManager::registerMonitorStateChangedHandler(InlineFunction<void(GLFWmonitor*, int)> handler) {
+        return CallbackHandler{ this, CallbackType::MonitorStateChanged, monitorStateChangedHandlers.add(std::move(handler), 0) };
     }
 
-    InputManager::CallbackHandler InputManager::registerWindowResizeHandler(std::function<void(int, int)> handler) {
-        windowResizeHandlers.emplace_back(std::move(handler), 0);
-        return CallbackHandler{this, CallbackType::WindowResize, windowResizeHandlers.size() - 1};
+    InputManager::CallbackHandler InputManager::registerTextCallback(InlineFunction<void(unsigned int)> handler) {
+        return CallbackHandler{ this, CallbackType::Text, textHandlers.add(std::move(handler), defaultPriority) };
     }
 
-    InputManager::CallbackHandler InputManager::registerWindowMoveHandler(std::function<void(int, int)> handler) {
-        windowMoveHandlers.emplace_back(std::move(handler), 0);
-        return CallbackHandler{ this, CallbackType::WindowMove, windowMoveHandlers.size() - 1 };
+    InputManager::CallbackHandler InputManager::registerWindowFocusHandler(InlineFunction<void(bool)> handler) {
+        return CallbackHandler{ this, CallbackType::WindowFocus, windowFocusHandlers.add(std::move(handler), defaultPriority) };
     }
 
-    InputManager::CallbackHandler InputManager::registerMonitorStateChangedHandler(std::function<void(GLFWmonitor*, int)> handler) {
-        monitorStateChangedHandlers.emplace_back(std::move(handler), 0);
-        return CallbackHandler{ this, CallbackType::MonitorStateChanged, monitorStateChangedHandlers.size() - 1 };
+    InputManager::CallbackHandler InputManager::registerWindowCloseHandler(InlineFunction<void()> handler) {
+        return CallbackHandler{ this, CallbackType::WindowClose, windowCloseHandlers.add(std::move(handler), defaultPriority) };
     }
 
-    InputManager::CallbackHandler InputManager::registerTextCallback(std::function<void(unsigned int)> handler) {
-        textHandlers.emplace_back(std::move(handler), defaultPriority);
-        return CallbackHandler{ this, CallbackType::Text, textHandlers.size() - 1 };
+    InputManager::CallbackHandler InputManager::registerJoystickButtonHandler(InlineFunction<void(int, int, Action)> handler) {
+        return CallbackHandler{ this, CallbackType::JoystickButton, joystickButtonHandlers.add(std::move(handler), 0) };
     }
 
-    InputManager::CallbackHandler InputManager::registerWindowFocusHandler(std::function<void(bool)> handler) {
-        windowFocusHandlers.emplace_back(std::move(handler), defaultPriority);
-        return CallbackHandler{ this, CallbackType::WindowFocus, windowFocusHandlers.size() - 1 };
+    InputManager::CallbackHandler InputManager::registerJoystickConnectionHandler(InlineFunction<void(int, bool)> handler) {
+        return CallbackHandler{ this, CallbackType::JoystickConnection, joystickConnectionHandlers.add(std::move(handler), 0) };
     }
 
-    InputManager::CallbackHandler InputManager::registerWindowCloseHandler(std::function<void()> handler) {
-        windowCloseHandlers.emplace_back(std::move(handler), defaultPriority);
-        return CallbackHandler{ this, CallbackType::WindowClose, windowCloseHandlers.size() - 1 };
+    InputManager::CallbackHandler InputManager::registerGamepadButtonHandler(InlineFunction<void(int, GamepadButton, Action)> handler) {
+        return CallbackHandler{ this, CallbackType::GamepadButton, gamepadButtonHandlers.add(std::move(handler), 0) };
+    }
+
+    InputManager::CallbackHandler InputManager::registerGamepadAxisHandler(InlineFunction<void(int, GamepadAxis, float)> handler) {
+        return CallbackHandler{ this, CallbackType::GamepadAxis, gamepadAxisHandlers.add(std::move(handler), 0) };
     }
 	
-	InputManager::CallbackHandler InputManager::registerPathDropHandler_impl2(std::function<void(const std::vector<std::string>&)> handler) {
-        pathDropHandlers.emplace_back(std::move(handler), 0);
-        return CallbackHandler{this, CallbackType::PathDrop, pathDropHandlers.size() - 1};
+	InputManager::CallbackHandler InputManager::registerPathDropHandler_impl2(InlineFunction<void(const std::vector<std::string>&)> handler) {
+        return CallbackHandler{ this, CallbackType::PathDrop, pathDropHandlers.add(std::move(handler), 0) };
     }
 
     void InputManager::setMouseMode(MouseMode mouseMode) {
-        int mod;
+        int mod = GLFW_CURSOR_NORMAL;
         switch (mouseMode) {
         case MouseMode::Disabled: mod = GLFW_CURSOR_DISABLED; break;
         case MouseMode::Enabled: mod = GLFW_CURSOR_NORMAL; break;
         }
-        executeOn([w = window, m = mod](){ glfwSetInputMode(w, GLFW_CURSOR, m); });
+        post([this, m = mod](){
+            glfwSetInputMode(window, GLFW_CURSOR, m);
+            dirtyFields |= CursorModeField;
+        });
     }
 
     int InputManager::getSpaceScanCode()
@@ -481,85 +1194,60 @@ namespace glfwim {
         return glfwGetKeyScancode(GLFW_KEY_LEFT);
     }
 
-    void InputManager::CallbackHandler::enable_impl(bool enable)
+    template <typename F>
+    void InputManager::visitRegistry(CallbackType type, F&& f)
     {
         switch (type)
         {
         default: assert(false); break;
-        case CallbackType::Key:
-            pInputManager->keyHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::Utf8Key:
-            pInputManager->utf8KeyHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::MouseButton:
-            pInputManager->mouseButtonHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::MouseScroll:
-            pInputManager->mouseScrollHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::CursorMovement:
-            pInputManager->cursorMovementHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::CursorPosition:
-            pInputManager->cursorPositionHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::WindowResize:
-            pInputManager->windowResizeHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::WindowMove:
-            pInputManager->windowMoveHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::CursorHold:
-            pInputManager->cursorHoldHandlers[index].setEnabled(enable);
-            break;
-		case CallbackType::PathDrop:
-            pInputManager->pathDropHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::MonitorStateChanged:
-            pInputManager->monitorStateChangedHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::Text:
-            pInputManager->textHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::WindowFocus:
-            pInputManager->windowFocusHandlers[index].setEnabled(enable);
-            break;
-        case CallbackType::WindowClose:
-            pInputManager->windowCloseHandlers[index].setEnabled(enable);
-            break;
+        case CallbackType::Key: f(keyHandlers); break;
+        case CallbackType::Utf8Key: f(utf8KeyHandlers); break;
+        case CallbackType::MouseButton: f(mouseButtonHandlers); break;
+        case CallbackType::MouseScroll: f(mouseScrollHandlers); break;
+        case CallbackType::CursorMovement: f(cursorMovementHandlers); break;
+        case CallbackType::CursorPosition: f(cursorPositionHandlers); break;
+        case CallbackType::WindowResize: f(windowResizeHandlers); break;
+        case CallbackType::WindowMove: f(windowMoveHandlers); break;
+        case CallbackType::CursorHold: f(holdHandlers); break;
+        case CallbackType::KeyLongPress: f(holdHandlers); break;
+        case CallbackType::PathDrop: f(pathDropHandlers); break;
+        case CallbackType::MonitorStateChanged: f(monitorStateChangedHandlers); break;
+        case CallbackType::Text: f(textHandlers); break;
+        case CallbackType::WindowFocus: f(windowFocusHandlers); break;
+        case CallbackType::WindowClose: f(windowCloseHandlers); break;
+        case CallbackType::JoystickButton: f(joystickButtonHandlers); break;
+        case CallbackType::JoystickConnection: f(joystickConnectionHandlers); break;
+        case CallbackType::GamepadButton: f(gamepadButtonHandlers); break;
+        case CallbackType::GamepadAxis: f(gamepadAxisHandlers); break;
         }
     }
-}
 
-glfwim::PerFrameGlobalInputData::PerFrameGlobalInputData()
-    : gamepadState{new GLFWgamepadstate()}
-{
-}
+    template <typename F>
+    void InputManager::forEachEventRegistry(F&& f)
+    {
+        // hold handlers belong to the poll thread, see elapsedTime()
+        for (auto type : { CallbackType::Key, CallbackType::Utf8Key, CallbackType::MouseButton, CallbackType::MouseScroll, CallbackType::CursorMovement,
+                           CallbackType::CursorPosition, CallbackType::WindowResize, CallbackType::WindowMove, CallbackType::PathDrop,
+                           CallbackType::MonitorStateChanged, CallbackType::Text, CallbackType::WindowFocus, CallbackType::WindowClose,
+                           CallbackType::JoystickButton, CallbackType::JoystickConnection, CallbackType::GamepadButton, CallbackType::GamepadAxis }) {
+            visitRegistry(type, f);
+        }
+    }
 
-glfwim::PerFrameGlobalInputData::PerFrameGlobalInputData(const PerFrameGlobalInputData& that)
-    : PerFrameGlobalInputData()
-{
-    *this = that;
-}
+    void InputManager::CallbackHandler::enable_impl(bool enable)
+    {
+        pInputManager->visitRegistry(type, [&](auto& registry) { registry.setEnabled(id, enable); });
+    }
 
-glfwim::PerFrameGlobalInputData& glfwim::PerFrameGlobalInputData::operator=(const PerFrameGlobalInputData& that)
-{
-    clipBoardString = that.clipBoardString;
-    for (int i = 0; i < 5; ++i) {
-        mouseButton[i] = that.mouseButton[i];
-    }
-    inputModeCursor = that.inputModeCursor;
-    joystickAxes = that.joystickAxes;
-    joystickButtons = that.joystickButtons;
-    *gamepadState = *that.gamepadState;
-    gamepadStateErrorCode = that.gamepadStateErrorCode;
-    monitors = that.monitors;
-    w = that.w;
-    h = that.h;
-    displayW = that.displayW;
-    displayH = that.displayH;
-    viewportData = that.viewportData;
-    timestamp = that.timestamp;
-    return *this;
+    void InputManager::CallbackHandler::remove()
+    {
+        pInputManager->visitRegistry(type, [&](auto& registry) { registry.remove(id); });
+    }
+
+    bool InputManager::CallbackHandler::isValid() const
+    {
+        bool valid = false;
+        pInputManager->visitRegistry(type, [&](auto& registry) { valid = registry.contains(id); });
+        return valid;
+    }
 }
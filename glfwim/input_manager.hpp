@@ -2,12 +2,33 @@
 #define INPUT_MANAGER_HPP
 
 #include <functional>
+#include <algorithm>
+#include <cmath>
+#include <array>
+#include <atomic>
 #include <vector>
+#include <deque>
 #include <cstring>
 #include <string>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <variant>
+#include <utility>
+#include <cstdint>
+#include <unordered_map>
+#include <type_traits>
 #include <future>
+#include <limits>
+#include <iterator>
 #include <readerwriterqueue/readerwriterqueue.h>
 #include <concurrentqueue/concurrentqueue.h>
+#include <glfwim/inline_function.hpp>
+#include <glfwim/timer_wheel.hpp>
+
+#ifndef GLFWIM_SNAPSHOT_HISTORY_SIZE
+#define GLFWIM_SNAPSHOT_HISTORY_SIZE 64
+#endif
 
 struct GLFWwindow;
 struct GLFWmonitor;
@@ -31,51 +52,184 @@ namespace glfwim {
         Leave = 0, Enter = 1
     };
 
+    // values match the GLFW_GAMEPAD_BUTTON_* and GLFW_GAMEPAD_AXIS_* indices
+    enum class GamepadButton {
+        A = 0, B = 1, X = 2, Y = 3, LeftBumper = 4, RightBumper = 5, Back = 6, Start = 7, Guide = 8,
+        LeftThumb = 9, RightThumb = 10, DpadUp = 11, DpadRight = 12, DpadDown = 13, DpadLeft = 14
+    };
+
+    enum class GamepadAxis {
+        LeftX = 0, LeftY = 1, RightX = 2, RightY = 3, LeftTrigger = 4, RightTrigger = 5
+    };
+
     enum class MouseMode {
         Disabled = 0, Enabled = 1
     };
 
+    // How a burst of cursor position or scroll events within one handleEvents() call reaches a handler:
+    // every event, only the last one, or the summed delta; the coalesced call is made once at the end.
+    enum class Coalescing {
+        All = 0, Last = 1, Accumulate = 2
+    };
+
+    struct VideoMode {
+        int width, height, redBits, greenBits, blueBits, refreshRate;
+    };
+
+    struct GamepadState {
+        unsigned char buttons[15];
+        float axes[6];
+    };
+
+    // a released gamepad: buttons up, sticks centered, triggers at their -1 rest position
+    inline constexpr GamepadState GamepadRestState{{}, {0.0f, 0.0f, 0.0f, 0.0f, -1.0f, -1.0f}};
+
+    struct PerFrameJoystickData {
+        static constexpr int MaxAxes = 16;
+        static constexpr int MaxButtons = 32;
+
+        int connected, isGamepad;
+        float axes[MaxAxes];
+        // axes after the joystick's AxisProcessing stage, see InputManager::setAxisProcessing()
+        float processedAxes[MaxAxes];
+        int axisCount;
+        unsigned char buttons[MaxButtons];
+        int buttonCount;
+        GamepadState gamepadState;
+    };
+
     struct PerFrameMonitorData {
-        std::unique_ptr<GLFWvidmode> videoMode;
+        GLFWmonitor* monitor;
+        VideoMode videoMode;
         int posX, posY, workAreaX, workAreaY, workAreaW, workAreaH;
         float scaleX, scaleY;
+    };
+
+    // Rebuilt only when the monitor setup changes; snapshots refer to it by version.
+    struct MonitorTopology {
+        static constexpr int MaxMonitors = 16;
 
-        PerFrameMonitorData() = default;
-        PerFrameMonitorData& operator=(const PerFrameMonitorData& that);
-        PerFrameMonitorData(const PerFrameMonitorData& that);
+        PerFrameMonitorData monitors[MaxMonitors];
+        int monitorCount;
+        unsigned version;
     };
 
     struct PerFramePerViewportData {
+        GLFWwindow* window;
         int focused, hovered, iconified;
         double cursorX, cursorY;
         int mouseButton[5];
         int posX, posY, width, height;
     };
 
+    // Per joystick axis pipeline, applied in this order: calibration maps center +- range to -1..1, the deadzone
+    // cuts small deflections and rescales the rest to full range (radially for axes paired with pairAxes(), per
+    // axis otherwise), the curve remaps the magnitude and smoothing low-pass filters the result (0 is off).
+    // Raw axis order is platform specific (e.g. LX, LY, LT, RX, RY, RT on Linux), so no axes are paired by default.
+    struct AxisProcessing {
+        static constexpr int CurveSize = 33;
+
+        AxisProcessing() {
+            for (int i = 0; i < PerFrameJoystickData::MaxAxes; ++i) {
+                center[i] = 0.0f;
+                range[i] = 1.0f;
+                partner[i] = -1;
+            }
+            setCurveExponent(1.0f);
+        }
+
+        // makes the two axes share a radial deadzone, like the x and y axes of a stick
+        void pairAxes(int x, int y) {
+            if (x < 0 || y < 0 || x >= PerFrameJoystickData::MaxAxes || y >= PerFrameJoystickData::MaxAxes || x == y) return;
+            partner[x] = y;
+            partner[y] = x;
+        }
+
+        // fills the curve with |x|^exponent
+        void setCurveExponent(float exponent) {
+            for (int i = 0; i < CurveSize; ++i) {
+                curve[i] = std::pow(i / float(CurveSize - 1), exponent);
+            }
+        }
+
+        float center[PerFrameJoystickData::MaxAxes];
+        float range[PerFrameJoystickData::MaxAxes];
+        float deadzone = 0.0f;
+        // the axis whose deflection joins this one's for the deadzone, -1 for a per axis deadzone
+        int partner[PerFrameJoystickData::MaxAxes];
+        // output magnitude for input magnitudes sampled uniformly over 0..1, linearly interpolated
+        float curve[CurveSize];
+        float smoothing = 0.0f;
+    };
+
+    // Fixed capacity and trivially copyable, so publishing a snapshot is a single flat copy.
     struct PerFrameGlobalInputData {
-        PerFrameGlobalInputData();
-        PerFrameGlobalInputData(const PerFrameGlobalInputData& that);
-        PerFrameGlobalInputData& operator=(const PerFrameGlobalInputData& that);
+        static constexpr int MaxJoysticks = 16;
+        static constexpr int MaxViewports = 16;
+        static constexpr int KeyBitWords = 512 / 64;
 
-        std::string clipBoardString;
         int mouseButton[5];
+        // Key code and mouse button bitsets; pressed and released hold the edges published after the snapshot last
+        // passed to InputManager::consumeEdges(), a key tapped or released and pressed again within one frame shows up in both.
+        uint64_t keyDown[KeyBitWords], keyPressed[KeyBitWords], keyReleased[KeyBitWords];
+        uint64_t mouseButtonDown, mouseButtonPressed, mouseButtonReleased;
         int inputModeCursor;
-        std::vector<float> joystickAxes;
-        std::vector<unsigned char> joystickButtons;
-        std::unique_ptr<GLFWgamepadstate> gamepadState;
-        int gamepadStateErrorCode;
-        std::vector<PerFrameMonitorData> monitors;
+        // indexed by GLFW joystick id, bit i of connectedJoysticks is set while joysticks[i] is connected
+        PerFrameJoystickData joysticks[MaxJoysticks];
+        uint32_t connectedJoysticks;
+        unsigned monitorTopologyVersion;
         int w, h, displayW, displayH;
-        std::unordered_map<GLFWwindow*, PerFramePerViewportData> viewportData;
+        PerFramePerViewportData viewportData[MaxViewports];
+        int viewportCount;
         double timestamp;
+        // position in publication order, the first published snapshot is 0
+        uint64_t sequence;
+
+        bool isKeyDown(int key) const { return testKeyBit(keyDown, key); }
+        bool wasKeyPressed(int key) const { return testKeyBit(keyPressed, key); }
+        bool wasKeyReleased(int key) const { return testKeyBit(keyReleased, key); }
+        bool isMouseButtonDown(MouseButton button) const { return (mouseButtonDown >> (int)button) & 1; }
+        bool wasMouseButtonPressed(MouseButton button) const { return (mouseButtonPressed >> (int)button) & 1; }
+        bool wasMouseButtonReleased(MouseButton button) const { return (mouseButtonReleased >> (int)button) & 1; }
+
+        static bool testKeyBit(const uint64_t* bits, int key) {
+            return key >= 0 && key < KeyBitWords * 64 && ((bits[key / 64] >> (key % 64)) & 1);
+        }
+
+        const PerFramePerViewportData* findViewport(GLFWwindow* window) const {
+            for (int i = 0; i < viewportCount; ++i) {
+                if (viewportData[i].window == window) return &viewportData[i];
+            }
+            return nullptr;
+        }
+
+        PerFramePerViewportData* findViewport(GLFWwindow* window) {
+            return const_cast<PerFramePerViewportData*>(std::as_const(*this).findViewport(window));
+        }
     };
 
+    static_assert(std::is_trivially_copyable_v<PerFrameGlobalInputData>);
+
     class InputManager {
+    public:
+        // Limits a single handleEvents() call; whatever is left stays queued, in order, for the next call.
+        struct EventBudget {
+            size_t maxEvents = std::numeric_limits<size_t>::max();
+            double maxSeconds = std::numeric_limits<double>::infinity();
+        };
+
     private:
-        struct CursorHoldData {
-            std::function<void(double, double)> handler;
-            double x, y;
-            double threshold2, timeToTrigger, startTime;
+        // Cursor holds and key long presses, both driven by holdTimers on the poll thread. A hold fires once
+        // triggerTicks after it started, then every repeatTicks while it lasts when those are not 0.
+        struct HoldData {
+            std::shared_ptr<InlineFunction<void(double, double)>> handler;
+            // the held key's scancode for long presses, -1 for cursor holds
+            int scancode;
+            double x, y, threshold2;
+            uint64_t triggerTicks, repeatTicks;
+            bool started;
+            TimerWheel::TimerId timer;
+            uint64_t expiry;
         };
 
     public:
@@ -84,6 +238,7 @@ namespace glfwim {
             return instance;
         }
 		InputManager() = default;
+		~InputManager();
 		InputManager(const InputManager&) = delete;
 		InputManager(InputManager&&) = delete;
 		InputManager& operator=(const InputManager&) = delete;
@@ -93,7 +248,12 @@ namespace glfwim {
         void initialize(GLFWwindow* window);
         void pollEvents();
         void runTasks();
+        // Runs queued tasks until the queue is empty or maxSeconds have passed, checked between dequeued batches
+        void runTasks(double maxSeconds);
         void handleEvents();
+        void handleEvents(const EventBudget& budget);
+        // Events left queued by the last budgeted handleEvents() call
+        size_t deferredEventCount() const;
         void fillInputState(PerFrameGlobalInputData* data);
         void setMouseMode(MouseMode mouseMode);
         void registerWindow(GLFWwindow* window);
@@ -103,18 +263,52 @@ namespace glfwim {
         void setCurrentKeyboardHandlerPriority(int priority);
         void setCurrentMouseHandlerPriority(int priority);
         void setDefaultHandlerPriority(int priority);
+        // glfwGetTime() timestamp and source window of the event currently being dispatched
+        double currentEventTime() const;
+        GLFWwindow* currentEventWindow() const;
+        // Re-reads the key names of the current keyboard layout; also done automatically on focus regain.
+        std::future<void> refreshKeyNames();
+
+        // The returned snapshot stays consistent until it is released; the poll thread never waits for readers.
+        const PerFrameGlobalInputData* acquireSnapshot();
+        void releaseSnapshot(const PerFrameGlobalInputData* snapshot);
+        // Frame boundary for the pressed and released edges: snapshots published afterwards drop the edges the given
+        // snapshot showed and keep accumulating the newer ones, however many publishes there are in between. Meant for
+        // the one reader that consumes edges, once per frame. Until the next publish acquireSnapshot() keeps returning
+        // the consumed snapshot, compare sequence to skip it.
+        void consumeEdges(const PerFrameGlobalInputData* snapshot);
+        // Reconstructs the state at a glfwGetTime() timestamp from the last GLFWIM_SNAPSHOT_HISTORY_SIZE published
+        // snapshots, interpolating cursor positions and joystick axes between the two around it. Later timestamps
+        // give the newest snapshot; false when the history does not reach back that far yet or anymore.
+        bool stateAt(double timestamp, PerFrameGlobalInputData* data) const;
+
+        // Served from a cache that is refetched lazily after focus regain or on request. Off the poll thread
+        // a stale cache is returned as is and the refetch is handed to the poll thread instead of blocking.
+        std::string getClipboardString();
+        std::future<void> requestClipboardString();
+        void setClipboardString(std::string text);
+        std::shared_ptr<const MonitorTopology> getMonitorTopology() const;
 
     public:
         enum class CallbackType { 
-            Key, Utf8Key, MouseButton, MouseScroll, CursorMovement, CursorPosition, WindowResize, WindowMove, CursorHold, PathDrop, MonitorStateChanged, Text, WindowFocus, WindowClose
+            Key, Utf8Key, MouseButton, MouseScroll, CursorMovement, CursorPosition, WindowResize, WindowMove, CursorHold, PathDrop, MonitorStateChanged, Text, WindowFocus, WindowClose,
+            JoystickButton, JoystickConnection, GamepadButton, GamepadAxis, KeyLongPress
+        };
+
+        // Generation checked reference to a registered handler, stale once the handler is removed.
+        struct HandlerId {
+            uint32_t slot = 0;
+            uint32_t generation = 0;
         };
 
         class CallbackHandler {
         public:
-            CallbackHandler(InputManager* inputManager, CallbackType type, size_t index) : pInputManager{inputManager}, type{type}, index{index} {}
+            CallbackHandler(InputManager* inputManager, CallbackType type, HandlerId id) : pInputManager{inputManager}, type{type}, id{id} {}
 
             void enable() { enable_impl(true); }
             void disable() { enable_impl(false); }
+            void remove();
+            bool isValid() const;
 
         private:
             void enable_impl(bool enable);
@@ -122,38 +316,86 @@ namespace glfwim {
         private:
             InputManager* pInputManager;
             CallbackType type;
-            size_t index;
+            HandlerId id;
+        };
+
+        // Removes the handler when it goes out of scope.
+        class ScopedCallbackHandler {
+        public:
+            ScopedCallbackHandler() = default;
+            ScopedCallbackHandler(CallbackHandler handler) : handler{handler} {}
+            ScopedCallbackHandler(ScopedCallbackHandler&& that) noexcept : handler{std::exchange(that.handler, std::nullopt)} {}
+            ScopedCallbackHandler& operator=(ScopedCallbackHandler&& that) noexcept {
+                if (this != &that) {
+                    reset();
+                    handler = std::exchange(that.handler, std::nullopt);
+                }
+                return *this;
+            }
+            ~ScopedCallbackHandler() { reset(); }
+
+            void reset() {
+                if (handler) handler->remove();
+                handler.reset();
+            }
+            CallbackHandler release() {
+                auto ret = *handler;
+                handler.reset();
+                return ret;
+            }
+            CallbackHandler* operator->() { return &*handler; }
+            explicit operator bool() const { return handler.has_value(); }
+
+        private:
+            std::optional<CallbackHandler> handler;
         };
 
         friend class CallbackHandler;
 
     public:
-        CallbackHandler registerKeyHandlerWithKey(std::function<void(int, Modifier, Action)> handler);
+        // Key and mouse button handlers run in ascending priority order. A handler returning true consumes the
+        // event, the handlers after it are skipped; handlers returning void never consume.
+        template <typename H>
+        CallbackHandler registerKeyHandlerWithKey(H handler) {
+            return registerKeyHandler_impl([h = std::move(handler)](int key, Modifier modifier, Action action){
+                return consumes(h, key, modifier, action);
+            }, false, KeyFilter{});
+        }
 
-        CallbackHandler registerKeyHandler(std::function<void(int, Modifier, Action)> handler);
+        template <typename H>
+        CallbackHandler registerKeyHandler(H handler) {
+            return registerKeyHandler_impl([h = std::move(handler)](int scancode, Modifier modifier, Action action){
+                return consumes(h, scancode, modifier, action);
+            }, true, KeyFilter{});
+        }
 
         template <typename H>
         CallbackHandler registerKeyHandler(int scancode, H handler) {
-            return registerKeyHandler([h = std::move(handler), s = scancode](int scancode, Modifier modifier, Action action){
-                if (scancode == s) h(modifier, action);
-            });
+            return registerKeyHandler_impl([h = std::move(handler)](int, Modifier modifier, Action action){
+                return consumes(h, modifier, action);
+            }, true, KeyFilter{scancode, std::nullopt, std::nullopt});
         }
 
         template <typename H>
         CallbackHandler registerKeyHandler(int scancode, Modifier modifier, H handler) {
-            return registerKeyHandler([h = std::move(handler), s = scancode, m = modifier](int scancode, Modifier modifier, Action action){
-                if (scancode == s && modifier == m) h(action);
-            });
+            return registerKeyHandler_impl([h = std::move(handler)](int, Modifier, Action action){
+                return consumes(h, action);
+            }, true, KeyFilter{scancode, modifier, std::nullopt});
         }
 
         template <typename H>
         CallbackHandler registerKeyHandler(int scancode, Modifier modifier, Action action, H handler) {
-            return registerKeyHandler([h = std::move(handler), s = scancode, m = modifier, a = action](int scancode, Modifier modifier, Action action){
-                if (scancode == s && modifier == m && action == a) h();
-            });
+            return registerKeyHandler_impl([h = std::move(handler)](int, Modifier, Action){
+                return consumes(h);
+            }, true, KeyFilter{scancode, modifier, action});
         }
 
-        CallbackHandler registerUtf8KeyHandler(std::function<void(const char*, Modifier, Action)> handler);
+        template <typename H>
+        CallbackHandler registerUtf8KeyHandler(H handler) {
+            return registerUtf8KeyHandler_impl([h = std::move(handler)](const char* utf8code, Modifier modifier, Action action){
+                return consumes(h, utf8code, modifier, action);
+            }, KeyFilter{});
+        }
 
         template <typename H>
         CallbackHandler registerUtf8KeyHandler(const char* utf8code, H handler) {
@@ -170,9 +412,9 @@ namespace glfwim {
                 return registerKeyHandler(getLeftArrowScanCode(), handler);
             }
             else {
-                return registerUtf8KeyHandler([h = std::move(handler), u = utf8code](const char* utf8code, Modifier modifier, Action action){
-                    if (!strcmp(u, utf8code)) h(modifier, action);
-                });
+                return registerUtf8KeyHandler_impl([h = std::move(handler)](const char*, Modifier modifier, Action action){
+                    return consumes(h, modifier, action);
+                }, KeyFilter{internKeyName(utf8code), std::nullopt, std::nullopt});
             }
         }
 
@@ -191,9 +433,9 @@ namespace glfwim {
                 return registerKeyHandler(getLeftArrowScanCode(), modifier, handler);
             }
             else {
-                return registerUtf8KeyHandler([h = std::move(handler), u = utf8code, m = modifier](const char* utf8code, Modifier modifier, Action action){
-                    if (!strcmp(u, utf8code) && m == modifier) h(action);
-                });
+                return registerUtf8KeyHandler_impl([h = std::move(handler)](const char*, Modifier, Action action){
+                    return consumes(h, action);
+                }, KeyFilter{internKeyName(utf8code), modifier, std::nullopt});
             }
         }
 
@@ -212,38 +454,51 @@ namespace glfwim {
                 return registerKeyHandler(getLeftArrowScanCode(), modifier, action, handler);
             }
             else {
-                return registerUtf8KeyHandler([h = std::move(handler), u = utf8code, m = modifier, a = action](const char* utf8code, Modifier modifier, Action action){
-                    if (!strcmp(u, utf8code) && m == modifier && a == action) h();
-                });
+                return registerUtf8KeyHandler_impl([h = std::move(handler)](const char*, Modifier, Action){
+                    return consumes(h);
+                }, KeyFilter{internKeyName(utf8code), modifier, action});
             }
         }
 
-        CallbackHandler registerMouseButtonHandler(std::function<void(MouseButton, Modifier, Action)> handler);
+        template <typename H>
+        CallbackHandler registerMouseButtonHandler(H handler) {
+            return registerMouseButtonHandler_impl([h = std::move(handler)](MouseButton mouseButton, Modifier modifier, Action action){
+                return consumes(h, mouseButton, modifier, action);
+            });
+        }
 
         template <typename H>
         CallbackHandler registerMouseButtonHandler(MouseButton mouseButton, H handler) {
-            return registerMouseButtonHandler([h = std::move(handler), mb = mouseButton](MouseButton mouseButton, Modifier modifier, Action action){
-                if (mb == mouseButton) h(modifier, action);
+            return registerMouseButtonHandler_impl([h = std::move(handler), mb = mouseButton](MouseButton mouseButton, Modifier modifier, Action action){
+                return mb == mouseButton && consumes(h, modifier, action);
             });
         }
 
         template <typename H>
         CallbackHandler registerMouseButtonHandler(MouseButton mouseButton, Modifier modifier, H handler) {
-            return registerMouseButtonHandler([h = std::move(handler), mb = mouseButton, m = modifier](MouseButton mouseButton, Modifier modifier, Action action){
-                if (mb == mouseButton && m == modifier) h(action);
+            return registerMouseButtonHandler_impl([h = std::move(handler), mb = mouseButton, m = modifier](MouseButton mouseButton, Modifier modifier, Action action){
+                return mb == mouseButton && m == modifier && consumes(h, action);
             });
         }
 
         template <typename H>
         CallbackHandler registerMouseButtonHandler(MouseButton mouseButton, Modifier modifier, Action action, H handler) {
-            return registerMouseButtonHandler([h = std::move(handler), mb = mouseButton, m = modifier, a = action](MouseButton mouseButton, Modifier modifier, Action action){
-                if (mb == mouseButton && m == modifier && a == action) h();
+            return registerMouseButtonHandler_impl([h = std::move(handler), mb = mouseButton, m = modifier, a = action](MouseButton mouseButton, Modifier modifier, Action action){
+                return mb == mouseButton && m == modifier && a == action && consumes(h);
             });
         }
 
-        CallbackHandler registerMouseScrollHandler(std::function<void(double, double)> handler);
+        template <typename H>
+        CallbackHandler registerMouseScrollHandler(H handler) {
+            return registerMouseScrollHandler(Coalescing::All, [h = std::move(handler)](double x, double y, int){
+                h(x, y);
+            });
+        }
+
+        // The last argument is the number of events folded into the call.
+        CallbackHandler registerMouseScrollHandler(Coalescing coalescing, InlineFunction<void(double, double, int)> handler);
 
-        CallbackHandler registerCursorMovementHandler(std::function<void(CursorMovement)> handler);
+        CallbackHandler registerCursorMovementHandler(InlineFunction<void(CursorMovement)> handler);
 
         template <typename H>
         CallbackHandler registerCursorMovementHandler(CursorMovement movement, H handler) {
@@ -252,12 +507,35 @@ namespace glfwim {
             });
         }
 
-        CallbackHandler registerCursorPositionHandler(std::function<void(double, double)> handler);
+        template <typename H>
+        CallbackHandler registerCursorPositionHandler(H handler) {
+            return registerCursorPositionHandler(Coalescing::All, [h = std::move(handler)](double x, double y, int){
+                h(x, y);
+            });
+        }
+
+        // With Coalescing::Accumulate the handler receives the cursor delta instead of the position.
+        CallbackHandler registerCursorPositionHandler(Coalescing coalescing, InlineFunction<void(double, double, int)> handler);
+
+        // Fires once the cursor stayed within threshold of a point for triggerTimeInMs, then again only after it
+        // moved away; with a repeat interval it keeps firing at that interval while the hold lasts.
+        CallbackHandler registerCursorHoldHandler(double triggerTimeInMs, double threshold, InlineFunction<void(double, double)> handler);
+        CallbackHandler registerCursorHoldHandler(double triggerTimeInMs, double threshold, double repeatIntervalInMs, InlineFunction<void(double, double)> handler);
 
-        CallbackHandler registerCursorHoldHandler(double triggerTimeInMs, double threshold, std::function<void(double, double)> handler);
+        template <typename H>
+        CallbackHandler registerKeyLongPressHandler(int scancode, double triggerTimeInMs, H handler) {
+            return registerKeyLongPressHandler(scancode, triggerTimeInMs, 0.0, std::move(handler));
+        }
 
-        CallbackHandler registerWindowResizeHandler(std::function<void(int, int)> handler);
-        CallbackHandler registerWindowMoveHandler(std::function<void(int, int)> handler);
+        template <typename H>
+        CallbackHandler registerKeyLongPressHandler(int scancode, double triggerTimeInMs, double repeatIntervalInMs, H handler) {
+            return registerHoldHandler_impl(CallbackType::KeyLongPress, scancode, triggerTimeInMs, 0.0, repeatIntervalInMs, [h = std::move(handler)](double, double){
+                h();
+            });
+        }
+
+        CallbackHandler registerWindowResizeHandler(InlineFunction<void(int, int)> handler);
+        CallbackHandler registerWindowMoveHandler(InlineFunction<void(int, int)> handler);
 		
 		template <typename Head, typename Second, typename... Args>
         CallbackHandler registerPathDropHandler(Head&& head, Second&& second, Args&&... args) {
@@ -270,16 +548,86 @@ namespace glfwim {
             return registerPathDropHandler_impl(std::vector<std::string>{}, std::forward<Handler>(handler));
         }
 
-        CallbackHandler registerMonitorStateChangedHandler(std::function<void(GLFWmonitor*, int)> handler);
-        CallbackHandler registerTextCallback(std::function<void(unsigned int)> handler);
-        CallbackHandler registerWindowFocusHandler(std::function<void(bool)> handler);
-        CallbackHandler registerWindowCloseHandler(std::function<void()> handler);
+        CallbackHandler registerMonitorStateChangedHandler(InlineFunction<void(GLFWmonitor*, int)> handler);
+        CallbackHandler registerTextCallback(InlineFunction<void(unsigned int)> handler);
+        CallbackHandler registerWindowFocusHandler(InlineFunction<void(bool)> handler);
+        CallbackHandler registerWindowCloseHandler(InlineFunction<void()> handler);
+
+        // Joystick and gamepad handlers sit outside the keyboard and mouse priority chains: a keyboard or mouse
+        // modal does not mute them, they are registered and dispatched at priority 0 like the window events.
+        CallbackHandler registerJoystickButtonHandler(InlineFunction<void(int, int, Action)> handler);
+
+        template <typename H>
+        CallbackHandler registerJoystickButtonHandler(int joystick, int button, H handler) {
+            return registerJoystickButtonHandler([h = std::move(handler), j = joystick, b = button](int joystick, int button, Action action){
+                if (j == joystick && b == button) h(action);
+            });
+        }
+
+        CallbackHandler registerJoystickConnectionHandler(InlineFunction<void(int, bool)> handler);
+
+        // Gamepad handlers receive the joystick id first; only joysticks with a gamepad mapping produce events.
+        CallbackHandler registerGamepadButtonHandler(InlineFunction<void(int, GamepadButton, Action)> handler);
+
+        template <typename H>
+        CallbackHandler registerGamepadButtonHandler(GamepadButton gamepadButton, H handler) {
+            return registerGamepadButtonHandler([h = std::move(handler), gb = gamepadButton](int joystick, GamepadButton gamepadButton, Action action){
+                if (gb == gamepadButton) h(joystick, action);
+            });
+        }
+
+        template <typename H>
+        CallbackHandler registerGamepadButtonHandler(GamepadButton gamepadButton, Action action, H handler) {
+            return registerGamepadButtonHandler([h = std::move(handler), gb = gamepadButton, a = action](int joystick, GamepadButton gamepadButton, Action action){
+                if (gb == gamepadButton && a == action) h(joystick);
+            });
+        }
+
+        // An axis event is produced once the axis moved at least its threshold away from the last reported value.
+        CallbackHandler registerGamepadAxisHandler(InlineFunction<void(int, GamepadAxis, float)> handler);
+
+        template <typename H>
+        CallbackHandler registerGamepadAxisHandler(GamepadAxis gamepadAxis, H handler) {
+            return registerGamepadAxisHandler([h = std::move(handler), ga = gamepadAxis](int joystick, GamepadAxis gamepadAxis, float value){
+                if (ga == gamepadAxis) h(joystick, value);
+            });
+        }
+
+        void setGamepadAxisThreshold(GamepadAxis axis, float threshold);
+        // Longest pollEvents() wait while a joystick is connected, as joysticks can only be polled.
+        void setJoystickPollInterval(double seconds);
+        // Takes effect on the poll thread with the next poll.
+        std::future<void> setAxisProcessing(int joystick, const AxisProcessing& processing);
 		
     private:
+        // code is a scancode for key handlers and an interned key name id for utf8 key handlers
+        struct KeyFilter {
+            std::optional<int> code;
+            std::optional<Modifier> modifier;
+            std::optional<Action> action;
+
+            bool matches(Modifier m, Action a) const { return (!modifier || *modifier == m) && (!action || *action == a); }
+        };
+
+        CallbackHandler registerKeyHandler_impl(InlineFunction<bool(int, Modifier, Action)> handler, bool useScancode, KeyFilter filter);
+        CallbackHandler registerUtf8KeyHandler_impl(InlineFunction<bool(const char*, Modifier, Action)> handler, KeyFilter filter);
+        CallbackHandler registerMouseButtonHandler_impl(InlineFunction<bool(MouseButton, Modifier, Action)> handler);
+        CallbackHandler registerHoldHandler_impl(CallbackType type, int scancode, double triggerTimeInMs, double threshold, double repeatIntervalInMs, InlineFunction<void(double, double)> handler);
+
+        template <typename H, typename... Args>
+        static bool consumes(const H& handler, Args&&... args) {
+            if constexpr (std::is_same_v<std::invoke_result_t<const H&, Args...>, bool>) {
+                return handler(std::forward<Args>(args)...);
+            } else {
+                handler(std::forward<Args>(args)...);
+                return false;
+            }
+        }
+
         template <typename T, typename = void> struct helper : std::false_type {};
         template <typename T> struct helper<T, std::void_t<decltype(std::declval<T>()(std::declval<std::string>()))>> : std::true_type {};
 
-        CallbackHandler registerPathDropHandler_impl2(std::function<void(const std::vector<std::string>&)> handler);
+        CallbackHandler registerPathDropHandler_impl2(InlineFunction<void(const std::vector<std::string>&)> handler);
 
         template <typename Handler>
         CallbackHandler registerPathDropHandler_impl(std::vector<std::string>&& filters, Handler&& handler) {
@@ -334,12 +682,97 @@ namespace glfwim {
         {
             auto pt = std::packaged_task<void()>(std::move(task));
             auto future = pt.get_future();
+            post([pt = std::move(pt)]() mutable { pt(); });
+            return future;
+        }
+
+        // Fire-and-forget executeOn(): the callable is stored inline in the task queue, no future and no shared state.
+        template <typename T>
+        void post(T task)
+        {
+            post_impl(nullptr, std::move(task));
+        }
+
+        // Moves count callables starting at first into the task queue with a single enqueue and a single wake-up.
+        template <typename It>
+        void postBulk(It first, size_t count)
+        {
+            postBulk_impl(nullptr, std::make_move_iterator(first), count);
+        }
+
+        template <typename It>
+        std::vector<std::future<void>> executeOnBulk(It first, size_t count)
+        {
+            return executeOnBulk_impl(nullptr, first, count);
+        }
+
+        // Submits through a producer token, which keeps the tasks of one thread in a sub-queue of their own and
+        // spares enqueues the lookup of it. A TaskProducer belongs to the thread using it and must not outlive
+        // the InputManager.
+        class TaskProducer {
+        public:
+            template <typename T>
+            void post(T task) { inputManager->post_impl(&token, std::move(task)); }
+
+            template <typename It>
+            void postBulk(It first, size_t count) { inputManager->postBulk_impl(&token, std::make_move_iterator(first), count); }
+
+            template <typename It>
+            std::vector<std::future<void>> executeOnBulk(It first, size_t count) { return inputManager->executeOnBulk_impl(&token, first, count); }
+
+        private:
+            friend class InputManager;
+            explicit TaskProducer(InputManager& inputManager) : inputManager{&inputManager}, token{inputManager.tasks} {}
+
+        private:
+            InputManager* inputManager;
+            moodycamel::ProducerToken token;
+        };
+
+        TaskProducer createTaskProducer() { return TaskProducer{*this}; }
+
+    private:
+        // a token is invalid when its producer could not be allocated, the tokenless enqueue is used instead
+        template <typename T>
+        void post_impl(moodycamel::ProducerToken* token, T&& task)
+        {
             if (std::this_thread::get_id() == mainThreadId) {
-                pt();
+                task();
             } else {
-                tasks.enqueue(std::move(pt));
+                if (token && token->valid()) tasks.enqueue(*token, InlineFunction<void()>(std::move(task)));
+                else tasks.enqueue(InlineFunction<void()>(std::move(task)));
+                wakePollThread();
+            }
+        }
+
+        // the queue constructs its InlineFunction elements in place from the (move) iterator
+        template <typename It>
+        void postBulk_impl(moodycamel::ProducerToken* token, It first, size_t count)
+        {
+            if (count == 0) return;
+            if (std::this_thread::get_id() == mainThreadId) {
+                for (size_t i = 0; i < count; ++i, ++first) (*first)();
+            } else {
+                if (token && token->valid()) tasks.enqueue_bulk(*token, first, count);
+                else tasks.enqueue_bulk(first, count);
+                wakePollThread();
             }
-            return future;
+        }
+
+        template <typename It>
+        std::vector<std::future<void>> executeOnBulk_impl(moodycamel::ProducerToken* token, It first, size_t count)
+        {
+            std::vector<std::future<void>> futures;
+            std::vector<InlineFunction<void()>> batch;
+            futures.reserve(count);
+            batch.reserve(count);
+            for (size_t i = 0; i < count; ++i, ++first) {
+                auto pt = std::packaged_task<void()>(std::move(*first));
+                futures.push_back(pt.get_future());
+                batch.emplace_back([pt = std::move(pt)]() mutable { pt(); });
+            }
+            postBulk_impl(token, std::make_move_iterator(batch.begin()), batch.size());
+            return futures;
         }
 
     private:
@@ -347,30 +780,30 @@ namespace glfwim {
         bool isMouseCaptured();
 
     private:
-        void elapsedTime();
+        // fires due hold timers, returns the glfwGetTime() of the next pending one or infinity
+        double elapsedTime();
+        void restartCursorHolds(double x, double y);
+        void restartKeyHolds(int scancode, int action);
+        void scheduleHold(size_t position, uint64_t expiry);
+        void fireHold(uint64_t payload, uint64_t expiry);
+        static uint64_t holdTicks();
+        void wakePollThread();
         void updateInputState();
+        void pollJoysticks();
+        void diffGamepadState(int jid, const GamepadState& previous, const GamepadState& current);
+        static void processAxes(const AxisProcessing& processing, const float* raw, int count, float* processed);
+        void setJoystickConnected(int jid, bool connected);
+        void claimJoysticks();
+        void releaseJoysticks();
+        void refreshInputState(PerFrameGlobalInputData* data, unsigned fields);
+        void fillViewportData(GLFWwindow* window, PerFramePerViewportData& data);
+        void fetchClipboardString();
+        void rebuildMonitorTopology();
         static int getSpaceScanCode();
         static int getEnterScanCode();
         static int getRightArrowScanCode();
         static int getLeftArrowScanCode();
 
-        template <typename Container>
-        static Container backupContainer(Container& container)
-        {
-            auto ret = std::move(container);
-            container.clear();
-            return ret;
-        }
-
-        template <typename Container>
-        static void restoreContainer(Container& container, Container& backup)
-        {
-            std::swap(container, backup);
-            if (!backup.empty()) {
-                container.insert(std::end(container), std::make_move_iterator(std::begin(backup)), std::make_move_iterator(std::end(backup)));
-            }
-        }
-
         template <typename T>
         struct HandlerHolder {
             HandlerHolder(T handler, int priority) 
@@ -398,60 +831,404 @@ namespace glfwim {
 
         template <typename T>
         struct KeyHandlerHolder : HandlerHolder<T> {
-            KeyHandlerHolder(T handler, bool useScancode, int priority)
+            KeyHandlerHolder(T handler, bool useScancode, KeyFilter filter, int priority)
                 : HandlerHolder<T>{std::move(handler), priority}
+                , filter{filter}
                 , useScancode{useScancode}
             {}
             bool usesScancode() const { return useScancode; }
+            KeyFilter filter;
         private:
             bool useScancode;
         };
 
+        // Slot map of handlers: dispatch walks a dense vector of live holders in registration order, handles
+        // resolve through a slot table with generation counters. Every mutation is deferred: additions wait in
+        // a pending list and removals leave a disabled tombstone, both applied by applyPending() at a safe point
+        // on the dispatching thread. Dispatch itself therefore never sees the container change, and a frame
+        // without registrations costs a single atomic load per registry.
+        template <typename Holder>
+        class HandlerRegistry {
+        public:
+            template <typename... Args>
+            HandlerId add(Args&&... args) {
+                std::lock_guard lock{mutex};
+                uint32_t slot;
+                if (freeSlots.empty()) {
+                    slot = (uint32_t)slots.size();
+                    slots.push_back(Slot{0, 1});
+                } else {
+                    slot = freeSlots.back();
+                    freeSlots.pop_back();
+                }
+                slots[slot].position = (uint32_t)pending.size() | Pending;
+                pending.emplace_back(std::forward<Args>(args)...);
+                pendingOwners.push_back(slot);
+                hasPendingChanges.store(true, std::memory_order::release);
+                return HandlerId{slot, slots[slot].generation};
+            }
+
+            bool remove(HandlerId id) {
+                std::lock_guard lock{mutex};
+                auto holder = find(id);
+                if (holder == nullptr) return false;
+                holder->setEnabled(false);
+                uint32_t position = slots[id.slot].position;
+                ((position & Pending) ? pendingOwners[position & ~Pending] : owners[position]) = Dead;
+                slots[id.slot].generation++;
+                freeSlots.push_back(id.slot);
+                if (!(position & Pending)) pendingRemovals++;
+                hasPendingChanges.store(true, std::memory_order::release);
+                return true;
+            }
+
+            bool setEnabled(HandlerId id, bool enable) {
+                std::lock_guard lock{mutex};
+                auto holder = find(id);
+                if (holder == nullptr) return false;
+                holder->setEnabled(enable);
+                return true;
+            }
+
+            bool contains(HandlerId id) {
+                std::lock_guard lock{mutex};
+                return find(id) != nullptr;
+            }
+
+
+            // safe point, only to be called by the thread that dispatches this registry, outside of dispatch
+            void applyPending() {
+                if (!hasPendingChanges.load(std::memory_order::acquire)) return;
+                // Declared before the lock so removed holders are only destroyed once it is released: a handler may
+                // own a ScopedCallbackHandler of this registry, whose destructor calls remove().
+                std::vector<Holder> retired, unsorted;
+                std::lock_guard lock{mutex};
+                hasPendingChanges.store(false, std::memory_order::relaxed);
+
+                if (pendingRemovals > 0) {
+                    size_t target = 0;
+                    for (size_t i = 0; i < holders.size(); ++i) {
+                        if (owners[i] == Dead) {
+                            retired.push_back(std::move(holders[i]));
+                            continue;
+                        }
+                        if (target != i) {
+                            holders[target] = std::move(holders[i]);
+                            owners[target] = owners[i];
+                            slots[owners[target]].position = (uint32_t)target;
+                        }
+                        target++;
+                    }
+                    holders.erase(holders.begin() + target, holders.end());
+                    owners.resize(target);
+                    pendingRemovals = 0;
+                }
+
+                for (size_t i = 0; i < pending.size(); ++i) {
+                    if (pendingOwners[i] == Dead) {
+                        retired.push_back(std::move(pending[i]));
+                        continue;
+                    }
+                    slots[pendingOwners[i]].position = (uint32_t)holders.size();
+                    holders.push_back(std::move(pending[i]));
+                    owners.push_back(pendingOwners[i]);
+                }
+                pending.clear();
+                pendingOwners.clear();
+                sortByPriority(unsorted);
+                layoutChanged = true;
+            }
+
+            // true once after applyPending() moved holders, i.e. positions held elsewhere are stale
+            bool takeLayoutChange() { return std::exchange(layoutChanged, false); }
+
+            size_t size() const { return holders.size(); }
+            Holder& operator[](size_t i) { return holders[i]; }
+            const Holder& operator[](size_t i) const { return holders[i]; }
+            auto begin() { return holders.begin(); }
+            auto end() { return holders.end(); }
+
+        private:
+            // dispatch order is ascending priority, registration order among equal priorities
+            void sortByPriority(std::vector<Holder>& previous) {
+                if (std::is_sorted(holders.begin(), holders.end(), [](auto& a, auto& b) { return a.priority < b.priority; })) return;
+                auto byPriority = [this](uint32_t a, uint32_t b) { return holders[a].priority < holders[b].priority; };
+                std::vector<uint32_t> order(holders.size());
+                for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+                std::stable_sort(order.begin(), order.end(), byPriority);
+
+                std::vector<Holder> sorted;
+                std::vector<uint32_t> sortedOwners;
+                sorted.reserve(holders.size());
+                sortedOwners.reserve(owners.size());
+                for (uint32_t i : order) {
+                    slots[owners[i]].position = (uint32_t)sorted.size();
+                    sorted.push_back(std::move(holders[i]));
+                    sortedOwners.push_back(owners[i]);
+                }
+                previous = std::exchange(holders, std::move(sorted));
+                owners = std::move(sortedOwners);
+            }
+
+            Holder* find(HandlerId id) {
+                if (id.slot >= slots.size() || slots[id.slot].generation != id.generation) return nullptr;
+                uint32_t position = slots[id.slot].position;
+                return (position & Pending) ? &pending[position & ~Pending] : &holders[position];
+            }
+
+        private:
+            static constexpr uint32_t Pending = 1u << 31;
+            static constexpr uint32_t Dead = ~0u;
+
+            struct Slot {
+                uint32_t position;
+                uint32_t generation;
+            };
+
+            // holders and owners are only restructured by applyPending() on the dispatching thread
+            std::vector<Holder> holders;
+            std::vector<uint32_t> owners;
+            std::vector<Holder> pending;
+            std::vector<uint32_t> pendingOwners;
+            std::vector<Slot> slots;
+            std::vector<uint32_t> freeSlots;
+            size_t pendingRemovals = 0;
+            std::atomic<bool> hasPendingChanges = false;
+            bool layoutChanged = false;
+            std::mutex mutex;
+        };
+
+        template <typename F>
+        void visitRegistry(CallbackType type, F&& f);
+        template <typename F>
+        void forEachEventRegistry(F&& f);
+
+        // keeps the pending coalesced value next to the handler, so coalescing never allocates
+        template <typename T>
+        struct CoalescingHandlerHolder : HandlerHolder<T> {
+            CoalescingHandlerHolder(T handler, Coalescing coalescing, int priority)
+                : HandlerHolder<T>{std::move(handler), priority}
+                , coalescing{coalescing}
+            {}
+            Coalescing coalescing;
+            double x = 0, y = 0;
+            int samples = 0;
+        };
+
+        using CoalescingHandler = CoalescingHandlerHolder<InlineFunction<void(double, double, int)>>;
+
+        using KeyHandler = KeyHandlerHolder<InlineFunction<bool(int, Modifier, Action)>>;
+        using Utf8KeyHandler = KeyHandlerHolder<InlineFunction<bool(const char*, Modifier, Action)>>;
+
+        // positions in a key handler container: handlers bound to one code, and handlers that want every key
+        struct KeyHandlerIndex {
+            std::unordered_map<int, std::vector<size_t>> byCode;
+            std::vector<size_t> catchAll;
+        };
+
+        template <typename Handlers>
+        static void rebuildKeyHandlerIndex(KeyHandlerIndex& index, const Handlers& handlers);
+        template <typename Handlers, typename F>
+        static bool forEachKeyHandler(Handlers& handlers, const KeyHandlerIndex& index, int code, Modifier modifier, Action action, F&& f);
+
+        struct KeyName {
+            int id;
+            const char* name;
+        };
+
+        struct KeyEvent { int key, scancode; Modifier modifier; Action action; KeyName name; };
+        struct MouseButtonEvent { MouseButton button; Modifier modifier; Action action; };
+        struct MouseScrollEvent { double x, y; };
+        struct CursorMovementEvent { CursorMovement movement; };
+        struct CursorPositionEvent { double x, y; };
+        struct WindowResizeEvent { int width, height; };
+        struct WindowMoveEvent { int x, y; };
+        struct CursorHoldEvent {};
+        struct PathDropEvent {};
+        struct MonitorStateChangedEvent { GLFWmonitor* monitor; int event; };
+        struct TextEvent { unsigned int codepoint; };
+        struct WindowFocusEvent { bool focused; };
+        struct WindowCloseEvent {};
+        struct JoystickButtonEvent { int joystick, button; Action action; };
+        struct JoystickConnectionEvent { int joystick; bool connected; };
+        struct GamepadButtonEvent { int joystick; GamepadButton button; Action action; };
+        struct GamepadAxisEvent { int joystick; GamepadAxis axis; float value; };
+
+        struct InputEvent {
+            double timestamp;
+            GLFWwindow* window;
+            std::variant<KeyEvent, MouseButtonEvent, MouseScrollEvent, CursorMovementEvent, CursorPositionEvent, WindowResizeEvent, WindowMoveEvent,
+                         CursorHoldEvent, PathDropEvent, MonitorStateChangedEvent, TextEvent, WindowFocusEvent, WindowCloseEvent,
+                         JoystickButtonEvent, JoystickConnectionEvent, GamepadButtonEvent, GamepadAxisEvent> data;
+        };
+
+        template <typename T>
+        void pushEvent(GLFWwindow* window, T data);
+        void dispatchKeyEvent(const KeyEvent& e);
+        static void updateButtonBits(uint64_t& down, uint64_t& pressedSince, uint64_t& releasedSince, int bit, int action);
+        void advanceEdges(uint64_t sequence);
+        void writeEdges(PerFrameGlobalInputData* data) const;
+
+        // The pressed and released edges one publish added, kept until consumeEdges() moves past that publish.
+        struct EdgeDelta {
+            uint64_t sequence = 0;
+            uint64_t keyPressed[PerFrameGlobalInputData::KeyBitWords] = {};
+            uint64_t keyReleased[PerFrameGlobalInputData::KeyBitWords] = {};
+            uint64_t mouseButtonPressed = 0, mouseButtonReleased = 0;
+
+            void merge(const EdgeDelta& that) {
+                for (int i = 0; i < PerFrameGlobalInputData::KeyBitWords; ++i) {
+                    keyPressed[i] |= that.keyPressed[i];
+                    keyReleased[i] |= that.keyReleased[i];
+                }
+                mouseButtonPressed |= that.mouseButtonPressed;
+                mouseButtonReleased |= that.mouseButtonReleased;
+            }
+        };
+        void dispatchMouseButtonEvent(const MouseButtonEvent& e);
+        void releaseKeysAbovePriority();
+        void releaseMouseButtonsAbovePriority();
+        void coalesce(HandlerRegistry<CoalescingHandler>& handlers, double x, double y, double dx, double dy);
+        void flushCoalesced(HandlerRegistry<CoalescingHandler>& handlers);
+
+        int internKeyName(const char* name);
+        void rebuildKeyNameTable();
+        KeyName keyNameFor(int key, int scancode);
+
+        struct SnapshotSlot {
+            PerFrameGlobalInputData data{};
+            std::atomic<int> readers = 0;
+        };
+
+        // Seqlock guarded copy of the snapshot published as the index-th one: sequence is odd while the poll
+        // thread writes it and 2 * (index + 1) once it is complete.
+        struct HistoryEntry {
+            std::atomic<uint64_t> sequence = 0;
+            PerFrameGlobalInputData data{};
+        };
+
+        void recordHistory(const PerFrameGlobalInputData& data);
+        bool readHistory(uint64_t index, PerFrameGlobalInputData* data) const;
+        bool readHistoryTime(uint64_t index, double* timestamp) const;
+
     public:
-        std::atomic<PerFrameGlobalInputData*> globalInputState;
         std::atomic<double> lastResizeTime;
 
+    private:
+        // parts of PerFrameGlobalInputData that a callback can invalidate, only touched on the poll thread
+        enum StateField : unsigned {
+            MouseButtonField = 1 << 0,
+            CursorModeField = 1 << 1,
+            JoystickField = 1 << 2,
+            MonitorField = 1 << 3,
+            WindowSizeField = 1 << 4,
+            MainViewportField = 1 << 5,
+            SecondaryViewportField = 1 << 6,
+            KeyboardField = 1 << 7,
+            AllFields = ~0u
+        };
+
     private:
         GLFWwindow* window;
         std::thread::id mainThreadId;
-        std::vector<int> keyStates;
-        PerFrameGlobalInputData* previousState;
+        unsigned dirtyFields = AllFields;
+        // poll thread key and mouse button bits; the pressed and released bits accumulate since the last
+        // publish and become its EdgeDelta in advanceEdges()
+        uint64_t keyDownBits[PerFrameGlobalInputData::KeyBitWords] = {};
+        uint64_t keyPressedBits[PerFrameGlobalInputData::KeyBitWords] = {};
+        uint64_t keyReleasedBits[PerFrameGlobalInputData::KeyBitWords] = {};
+        uint64_t mouseButtonDownBits = 0, mouseButtonPressedBits = 0, mouseButtonReleasedBits = 0;
+        // deltas of the publishes that added edges, oldest first; when full the two oldest are merged, so a consumer
+        // lagging this many edge carrying publishes behind can see an edge a second time but never misses one
+        std::array<EdgeDelta, 8> edgeDeltas{};
+        int edgeDeltaCount = 0;
+        // deltas published before this sequence were seen by the frame consumer
+        std::atomic<uint64_t> consumedEdgeSequence = 0;
+        // Held keys as a dense list, indexed by key code through pressedKeyPositions (-1 while up), so priority
+        // transitions only visit keys that are actually down. priority is the bound the press was delivered under.
+        struct PressedKey {
+            int key, scancode, priority;
+            KeyName name;
+        };
+        std::vector<PressedKey> pressedKeys;
+        std::vector<int> pressedKeyPositions;
+        // per mouse button the priority it was pressed under, -1 while released
+        std::array<int, 8> mouseButtonStates;
+        // interned key names, element addresses stay valid so events can carry the name pointer
+        std::mutex keyNameMutex;
+        std::deque<std::string> keyNames;
+        std::unordered_map<std::string, int> keyNameIds;
+        // layout dependent GLFW key -> name table, owned by the poll thread
+        std::vector<KeyName> keyNameTable;
+        std::array<SnapshotSlot, 3> snapshots;
+        std::atomic<int> publishedSnapshot = 0;
+        // joystick callbacks carry no window, so they go to a single manager: the first one initialized, or the
+        // manager it is registered with through registerInputManager()
+        static inline InputManager* joystickOwner = nullptr;
+        // poll thread joystick state, only connected slots are queried and copied into snapshots
+        std::array<PerFrameJoystickData, PerFrameGlobalInputData::MaxJoysticks> joystickStates{};
+        uint32_t connectedJoystickBits = 0;
+        std::atomic<double> joystickPollInterval = 0.01;
+        double lastPollTime = 0;
+        double nextHoldDeadline = 0;
+        std::array<AxisProcessing, PerFrameGlobalInputData::MaxJoysticks> axisProcessing;
+        // per joystick the axis values last sent as events, and the change needed per axis to send a new one
+        std::array<std::array<float, 6>, PerFrameGlobalInputData::MaxJoysticks> reportedGamepadAxes{};
+        std::array<std::atomic<float>, 6> gamepadAxisThresholds{ 0.01f, 0.01f, 0.01f, 0.01f, 0.01f, 0.01f };
+        std::array<HistoryEntry, GLFWIM_SNAPSHOT_HISTORY_SIZE> history;
+        std::atomic<uint64_t> historyCount = 0;
+        std::mutex clipboardMutex;
+        std::string clipboardString;
+        std::atomic<bool> clipboardStale = true;
+        std::atomic<bool> clipboardFetchQueued = false;
+        std::atomic<std::shared_ptr<const MonitorTopology>> monitorTopology;
+        unsigned monitorTopologyVersion = 0;
         std::vector<GLFWwindow*> secondaryWindows;
         std::vector<InputManager*> secondaryInputManagers;
         int defaultPriority, currentKeyboardPriority, currentMousePriority, previousKeyboardPriority, previousMousePriority;
 
     private:
-        std::vector<KeyHandlerHolder<std::function<void(int, Modifier, Action)>>> keyHandlers;
-        std::vector<HandlerHolder<std::function<void(const char*, Modifier, Action)>>> utf8KeyHandlers;
-        std::vector<HandlerHolder<std::function<void(MouseButton, Modifier, Action)>>> mouseButtonHandlers;
-        std::vector<HandlerHolder<std::function<void(double, double)>>> mouseScrollHandlers;
-        std::vector<HandlerHolder<std::function<void(CursorMovement)>>> cursorMovementHandlers;
-        std::vector<HandlerHolder<std::function<void(double, double)>>> cursorPositionHandlers;
-        std::vector<HandlerHolder<std::function<void(int, int)>>> windowResizeHandlers;
-        std::vector<HandlerHolder<std::function<void(int, int)>>> windowMoveHandlers;
-        std::vector<HandlerHolder<std::function<void(GLFWmonitor*, int)>>> monitorStateChangedHandlers;
-        std::vector<HandlerHolder<std::function<void(unsigned int)>>> textHandlers;
-        std::vector<HandlerHolder<CursorHoldData>> cursorHoldHandlers;
-		std::vector<HandlerHolder<std::function<void(const std::vector<std::string>& paths)>>> pathDropHandlers;
-        std::vector<HandlerHolder<std::function<void(bool)>>> windowFocusHandlers;
-        std::vector<HandlerHolder<std::function<void()>>> windowCloseHandlers;
-
-        moodycamel::ReaderWriterQueue<std::tuple<int, int, Modifier, Action>> keyEventQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<MouseButton, Modifier, Action>> mouseButtonEventQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<double, double>> mouseScrollEventQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<CursorMovement>> cursorMovementEventQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<double, double>> cursorPositionEventQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<int, int>> windowResizeEventQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<int, int>> windowMoveEventQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<GLFWmonitor*, int>> monitorStateChangedEventQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<unsigned int>> textEventQueue;
-        moodycamel::ReaderWriterQueue<std::function<void(void)>> cursorHoldEventCallbackQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<std::vector<std::string>>> pathDropEventQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<int>> windowFocusEventQueue;
-        moodycamel::ReaderWriterQueue<std::tuple<>> windowCloseEventQueue;
+        HandlerRegistry<KeyHandler> keyHandlers;
+        KeyHandlerIndex keyHandlerIndex;
+        HandlerRegistry<Utf8KeyHandler> utf8KeyHandlers;
+        KeyHandlerIndex utf8KeyHandlerIndex;
+        HandlerRegistry<HandlerHolder<InlineFunction<bool(MouseButton, Modifier, Action)>>> mouseButtonHandlers;
+        HandlerRegistry<CoalescingHandler> mouseScrollHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void(CursorMovement)>>> cursorMovementHandlers;
+        HandlerRegistry<CoalescingHandler> cursorPositionHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void(int, int)>>> windowResizeHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void(int, int)>>> windowMoveHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void(GLFWmonitor*, int)>>> monitorStateChangedHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void(unsigned int)>>> textHandlers;
+        HandlerRegistry<HandlerHolder<HoldData>> holdHandlers;
+        // Millisecond ticks, owned by the poll thread. A timer payload is the holder's position tagged with the layout
+        // epoch it was scheduled in; applyPending() moving holders bumps the epoch and reschedules the live timers,
+        // so timers of removed holders are recognized as stale and the poll thread never needs the registry lock.
+        TimerWheel holdTimers;
+        uint32_t holdLayoutEpoch = 0;
+		HandlerRegistry<HandlerHolder<InlineFunction<void(const std::vector<std::string>& paths)>>> pathDropHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void(bool)>>> windowFocusHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void()>>> windowCloseHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void(int, int, Action)>>> joystickButtonHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void(int, bool)>>> joystickConnectionHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void(int, GamepadButton, Action)>>> gamepadButtonHandlers;
+        HandlerRegistry<HandlerHolder<InlineFunction<void(int, GamepadAxis, float)>>> gamepadAxisHandlers;
+
+        // single producer (the poll thread) stream of every input event in arrival order
+        moodycamel::ReaderWriterQueue<InputEvent> events{512};
+        // payloads too large for an event record, consumed in step with their PathDropEvent / CursorHoldEvent
+        moodycamel::ReaderWriterQueue<std::vector<std::string>> pathDropPayloads;
+        moodycamel::ReaderWriterQueue<InlineFunction<void(void)>> cursorHoldPayloads;
+        double dispatchedEventTime = 0;
+        GLFWwindow* dispatchedEventWindow = nullptr;
+        std::atomic<size_t> deferredEvents = 0;
+        // last dispatched cursor position, the base of accumulated cursor deltas
+        std::optional<CursorPositionEvent> lastCursorPosition;
 
     private:
-        moodycamel::ConcurrentQueue<std::packaged_task<void()>> tasks;
+        moodycamel::ConcurrentQueue<InlineFunction<void()>> tasks;
+        // only runTasks() dequeues, always from the main thread
+        moodycamel::ConsumerToken taskConsumer{tasks};
     };
 }
 #endif
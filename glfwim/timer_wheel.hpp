@@ -0,0 +1,176 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace glfwim {
+    // Hierarchical timer wheel over integer ticks: 6 levels of 64 slots, a timer sits on the level where its expiry
+    // first differs from the current tick and moves down a level whenever the wheel reaches its slot. Scheduling,
+    // cancelling and firing are O(1), advancing skips empty stretches a whole level at a time. Timer nodes come
+    // from a free list, so after warm-up neither scheduling nor firing allocates.
+    class TimerWheel {
+    public:
+        struct TimerId {
+            uint32_t index = Nil;
+            uint32_t generation = 0;
+        };
+
+        explicit TimerWheel(uint64_t now = 0) : current{now} {
+            heads.fill(Nil);
+        }
+
+        // an expiry at or before now() fires with the next advance()
+        TimerId schedule(uint64_t expiry, uint64_t payload) {
+            uint32_t index;
+            if (freeNodes.empty()) {
+                index = (uint32_t)nodes.size();
+                nodes.push_back(Node{});
+            } else {
+                index = freeNodes.back();
+                freeNodes.pop_back();
+            }
+            auto& node = nodes[index];
+            node.expiry = expiry;
+            node.payload = payload;
+            node.scheduled = true;
+            link(index);
+            return TimerId{index, node.generation};
+        }
+
+        bool cancel(TimerId id) {
+            if (!isScheduled(id)) return false;
+            unlink(id.index);
+            release(id.index);
+            return true;
+        }
+
+        bool isScheduled(TimerId id) const {
+            return id.index < nodes.size() && nodes[id.index].generation == id.generation && nodes[id.index].scheduled;
+        }
+
+        // Moves the wheel to now and calls onExpired(payload, expiry) for every timer that became due, in expiry
+        // order. onExpired may schedule and cancel timers, including rescheduling the one that just fired.
+        template <typename F>
+        void advance(uint64_t now, F&& onExpired) {
+            if (now < current) return;
+            while (true) {
+                uint32_t& head = heads[current & SlotMask];
+                while (head != Nil) {
+                    uint32_t index = head;
+                    unlink(index);
+                    uint64_t expiry = nodes[index].expiry, payload = nodes[index].payload;
+                    release(index);
+                    onExpired(payload, expiry);
+                }
+                if (current == now) break;
+
+                // nothing can become due before the next boundary of the lowest occupied level
+                int level = 0;
+                while (level < Levels && occupied[level] == 0) ++level;
+                uint64_t next = now;
+                if (level < Levels) {
+                    uint64_t granularity = uint64_t{1} << (SlotBits * level);
+                    next = std::min(now, (current / granularity + 1) * granularity);
+                }
+                current = next;
+                cascade();
+            }
+        }
+
+        // Lower bound of the earliest expiry, exact for timers due within the current 64 ticks; max() when empty.
+        uint64_t nextExpiry() const {
+            for (int level = 0; level < Levels; ++level) {
+                if (occupied[level] == 0) continue;
+                int shift = SlotBits * level;
+                uint64_t slot = (uint64_t)std::countr_zero(occupied[level]);
+                uint64_t block = current >> (shift + SlotBits) << (shift + SlotBits);
+                return std::max(current, block | (slot << shift));
+            }
+            return std::numeric_limits<uint64_t>::max();
+        }
+
+        uint64_t now() const { return current; }
+
+    private:
+        static constexpr uint32_t Nil = ~0u;
+        static constexpr int SlotBits = 6;
+        static constexpr int Levels = 6;
+        static constexpr uint64_t SlotCount = uint64_t{1} << SlotBits;
+        static constexpr uint64_t SlotMask = SlotCount - 1;
+
+        struct Node {
+            uint64_t expiry = 0, payload = 0;
+            uint32_t prev = Nil, next = Nil;
+            uint32_t bucket = 0;
+            uint32_t generation = 0;
+            bool scheduled = false;
+        };
+
+        void link(uint32_t index) {
+            auto& node = nodes[index];
+            uint64_t expiry = std::max(node.expiry, current);
+            int level = expiry == current ? 0 : (63 - std::countl_zero(expiry ^ current)) / SlotBits;
+            uint64_t slot;
+            if (level < Levels) {
+                slot = (expiry >> (SlotBits * level)) & SlotMask;
+            } else {
+                // beyond the wheel's range: park in the farthest top level slot, cascading re-links it later
+                level = Levels - 1;
+                slot = ((current >> (SlotBits * level)) - 1) & SlotMask;
+            }
+            uint32_t bucket = (uint32_t)(level * SlotCount + slot);
+            node.bucket = bucket;
+            node.prev = Nil;
+            node.next = heads[bucket];
+            if (node.next != Nil) nodes[node.next].prev = index;
+            heads[bucket] = index;
+            occupied[level] |= uint64_t{1} << slot;
+        }
+
+        void unlink(uint32_t index) {
+            auto& node = nodes[index];
+            if (node.prev != Nil) nodes[node.prev].next = node.next;
+            else heads[node.bucket] = node.next;
+            if (node.next != Nil) nodes[node.next].prev = node.prev;
+            if (heads[node.bucket] == Nil) occupied[node.bucket / SlotCount] &= ~(uint64_t{1} << (node.bucket % SlotCount));
+        }
+
+        void release(uint32_t index) {
+            auto& node = nodes[index];
+            node.scheduled = false;
+            node.generation++;
+            freeNodes.push_back(index);
+        }
+
+        // On a level boundary the slot just reached on every rolled over level is spread over the levels below,
+        // highest level first so its timers can still be picked up by the lower cascades.
+        void cascade() {
+            int rolled = 0;
+            while (rolled + 1 < Levels && (current & ((uint64_t{1} << (SlotBits * (rolled + 1))) - 1)) == 0) ++rolled;
+            for (int level = rolled; level >= 1; --level) {
+                uint32_t bucket = (uint32_t)(level * SlotCount + ((current >> (SlotBits * level)) & SlotMask));
+                uint32_t index = heads[bucket];
+                heads[bucket] = Nil;
+                occupied[level] &= ~(uint64_t{1} << (bucket % SlotCount));
+                while (index != Nil) {
+                    uint32_t next = nodes[index].next;
+                    link(index);
+                    index = next;
+                }
+            }
+        }
+
+    private:
+        uint64_t current;
+        std::array<uint32_t, Levels * SlotCount> heads;
+        std::array<uint64_t, Levels> occupied{};
+        std::vector<Node> nodes;
+        std::vector<uint32_t> freeNodes;
+    };
+}
+#endif
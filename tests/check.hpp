@@ -0,0 +1,16 @@
+#ifndef GLFWIM_TESTS_CHECK_HPP
+#define GLFWIM_TESTS_CHECK_HPP
+
+#include <cstdio>
+#include <cstdlib>
+
+// Aborts the test with the failed condition; usable from any thread.
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::abort(); \
+        } \
+    } while (0)
+
+#endif
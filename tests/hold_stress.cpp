@@ -0,0 +1,127 @@
+// Registers, toggles and removes cursor holds and key long presses from several threads while the poll thread
+// evaluates hold timers (elapsedTime() / fireHold()) and a dispatch thread runs handleEvents(). Meant to run
+// under -fsanitize=thread: the poll thread reads hold holders without the registry lock, so any access the
+// registry does not order shows up as a race report.
+#include <glfwim/input_manager.hpp>
+#include <glfw_stub.hpp>
+#include "check.hpp"
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace glfwim;
+
+namespace {
+    constexpr int RegistrarCount = 3;
+    constexpr int PollIterations = 20000;
+    constexpr int LiveHandlersPerThread = 16;
+    constexpr int ScancodeCount = 4;
+
+    std::atomic<uint64_t> fired = 0;
+
+    void registrar(InputManager& im, const std::atomic<bool>& stop, unsigned seed) {
+        std::mt19937 rng{seed};
+        std::vector<InputManager::CallbackHandler> live;
+        auto onHold = [](double, double) { fired.fetch_add(1, std::memory_order::relaxed); };
+
+        while (!stop.load()) {
+            switch (rng() % 6) {
+            case 0:
+                live.push_back(im.registerCursorHoldHandler(1.0 + rng() % 4, 2.0, onHold));
+                break;
+            case 1:
+                live.push_back(im.registerCursorHoldHandler(1.0 + rng() % 4, 2.0, 1.0 + rng() % 3, onHold));
+                break;
+            case 2:
+                live.push_back(im.registerKeyLongPressHandler((int)(rng() % ScancodeCount), 1.0 + rng() % 4, 1.0, [](){ fired.fetch_add(1, std::memory_order::relaxed); }));
+                break;
+            case 3: {
+                // a handler owning another hold of the same registry: removing it removes the inner one too
+                InputManager::ScopedCallbackHandler inner = im.registerCursorHoldHandler(2.0, 2.0, onHold);
+                live.push_back(im.registerCursorHoldHandler(1.0, 2.0, [inner = std::move(inner), onHold](double x, double y) { onHold(x, y); }));
+                break;
+            }
+            case 4:
+                if (!live.empty()) {
+                    auto& handler = live[rng() % live.size()];
+                    if (rng() % 2) handler.enable();
+                    else handler.disable();
+                }
+                break;
+            case 5:
+                if (!live.empty()) {
+                    size_t i = rng() % live.size();
+                    live[i].remove();
+                    CHECK(!live[i].isValid());
+                    live[i] = live.back();
+                    live.pop_back();
+                }
+                break;
+            }
+            if (live.size() > LiveHandlersPerThread) {
+                live.front().remove();
+                live.erase(live.begin());
+            }
+            std::this_thread::yield();
+        }
+
+        for (auto& handler : live) handler.remove();
+    }
+
+    // one poll thread iteration: time moves on by a tick, some keys and cursor moves restart holds
+    void pollOnce(InputManager& im, GLFWwindow* window, int i) {
+        glfwstub::advanceTime(0.001);
+        if (i % 7 == 0) {
+            int scancode = (i / 7) % ScancodeCount;
+            glfwstub::key(window, 'A' + scancode, scancode, (i / 7 / ScancodeCount) % 2 ? GLFW_RELEASE : GLFW_PRESS);
+        }
+        if (i % 23 == 0) glfwstub::cursorPos(window, (i / 23) % 2 * 10.0, 0.0);
+        im.pollEvents();
+    }
+}
+
+int main() {
+    auto window = glfwstub::createWindow();
+    auto im = std::make_unique<InputManager>();
+    im->initialize(window);
+
+    std::atomic<bool> stopRegistrars = false, stopDispatch = false;
+    std::vector<std::thread> registrars;
+    for (int i = 0; i < RegistrarCount; ++i) {
+        registrars.emplace_back(registrar, std::ref(*im), std::cref(stopRegistrars), 1234u + i);
+    }
+    std::thread dispatcher{[&]() {
+        while (!stopDispatch.load()) {
+            im->handleEvents();
+            std::this_thread::yield();
+        }
+    }};
+
+    for (int i = 0; i < PollIterations; ++i) {
+        pollOnce(*im, window, i);
+    }
+    stopRegistrars.store(true);
+    for (auto& t : registrars) t.join();
+    stopDispatch.store(true);
+    dispatcher.join();
+    CHECK(fired.load() > 0);
+
+    // every hold is removed by now: once the removals are applied and the fired ones drained, none may fire again
+    for (int i = 0; i < 16; ++i) {
+        pollOnce(*im, window, i);
+        im->handleEvents();
+    }
+    fired.store(0);
+    for (int i = 0; i < 2000; ++i) {
+        pollOnce(*im, window, i);
+        im->handleEvents();
+    }
+    CHECK(fired.load() == 0);
+
+    im.reset();
+    glfwstub::destroyWindow(window);
+    return 0;
+}
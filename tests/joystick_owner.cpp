@@ -0,0 +1,74 @@
+// Joystick connection callbacks reach exactly one manager: the first one initialized, or the primary a secondary is
+// registered with. Destroying the owner must leave no dangling pointer behind for the next callback.
+#include <glfwim/input_manager.hpp>
+#include <glfw_stub.hpp>
+#include "check.hpp"
+
+#include <memory>
+
+using namespace glfwim;
+
+namespace {
+    bool connected(InputManager& im, int jid) {
+        im.pollEvents();
+        auto snapshot = im.acquireSnapshot();
+        bool result = (snapshot->connectedJoysticks >> jid) & 1;
+        im.releaseSnapshot(snapshot);
+        return result;
+    }
+
+    void firstInitializedOwns(GLFWwindow* window) {
+        auto primary = std::make_unique<InputManager>();
+        primary->initialize(window);
+        auto secondary = std::make_unique<InputManager>();
+        secondary->initialize(window);
+        primary->registerInputManager(secondary.get());
+
+        glfwstub::joystick(0, true);
+        CHECK(connected(*primary, 0));
+        CHECK(!connected(*secondary, 0));
+
+        // the owner goes away first, the next callback must not reach it
+        primary->removeRegisteredInputManager(secondary.get());
+        primary.reset();
+        glfwstub::joystick(0, false);
+        CHECK(!connected(*secondary, 0));
+        glfwstub::joystick(0, true);
+        secondary.reset();
+
+        // a manager created afterwards owns the joysticks again and sees the one already plugged in
+        auto next = std::make_unique<InputManager>();
+        next->initialize(window);
+        CHECK(connected(*next, 0));
+        glfwstub::joystick(0, false);
+        CHECK(!connected(*next, 0));
+    }
+
+    void registeringHandsOwnershipToThePrimary(GLFWwindow* window) {
+        glfwstub::joystick(1, true);
+        auto secondary = std::make_unique<InputManager>();
+        secondary->initialize(window);
+        CHECK(connected(*secondary, 1));
+
+        auto primary = std::make_unique<InputManager>();
+        primary->initialize(window);
+        CHECK(!connected(*primary, 1));
+        primary->registerInputManager(secondary.get());
+        CHECK(connected(*primary, 1));
+        CHECK(!connected(*secondary, 1));
+
+        glfwstub::joystick(1, false);
+        CHECK(!connected(*primary, 1));
+        primary->removeRegisteredInputManager(secondary.get());
+    }
+}
+
+int main() {
+    auto window = glfwstub::createWindow();
+
+    firstInitializedOwns(window);
+    registeringHandsOwnershipToThePrimary(window);
+
+    glfwstub::destroyWindow(window);
+    return 0;
+}
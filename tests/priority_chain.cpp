@@ -0,0 +1,87 @@
+// Dispatch order and consumption of the priority sorted key, utf8 and mouse button chains, driven through the
+// GLFW stub on a single thread.
+#include <glfwim/input_manager.hpp>
+#include <glfw_stub.hpp>
+#include "check.hpp"
+
+#include <memory>
+#include <string>
+
+using namespace glfwim;
+
+namespace {
+    constexpr int KeyA = 'A';
+    constexpr int ScancodeA = 38;
+
+    // a release whose press was never seen, e.g. a button held down while the window opened, still arrives
+    void releaseWithoutPress(InputManager& im, GLFWwindow* window) {
+        int mouseReleases = 0, keyReleases = 0;
+        InputManager::ScopedCallbackHandler mouse = im.registerMouseButtonHandler(MouseButton::Left, [&](Modifier, Action action) {
+            if (action == Action::Release) ++mouseReleases;
+        });
+        InputManager::ScopedCallbackHandler key = im.registerKeyHandler(ScancodeA, [&](Modifier, Action action) {
+            if (action == Action::Release) ++keyReleases;
+        });
+        im.handleEvents();
+
+        glfwstub::mouseButton(window, 0, GLFW_RELEASE);
+        glfwstub::key(window, KeyA, ScancodeA, GLFW_RELEASE);
+        im.handleEvents();
+        CHECK(mouseReleases == 1);
+        CHECK(keyReleases == 1);
+    }
+
+    // a consuming scancode handler only hides the utf8 handlers ranked after it, not the ones ranked before it
+    void chainsInterleaveByPriority(InputManager& im, GLFWwindow* window) {
+        std::string order;
+        auto press = [&] {
+            order.clear();
+            glfwstub::key(window, KeyA, ScancodeA, GLFW_PRESS);
+            glfwstub::key(window, KeyA, ScancodeA, GLFW_RELEASE);
+            im.handleEvents();
+        };
+        im.setCurrentKeyboardHandlerPriority(3);
+
+        im.setDefaultHandlerPriority(1);
+        InputManager::ScopedCallbackHandler before = im.registerUtf8KeyHandler("a", Modifier::None, Action::Press, [&] { order += 'b'; });
+        im.setDefaultHandlerPriority(2);
+        InputManager::ScopedCallbackHandler key = im.registerKeyHandler(ScancodeA, Modifier::None, Action::Press, [&] { order += 'k'; return true; });
+        im.setDefaultHandlerPriority(3);
+        InputManager::ScopedCallbackHandler after = im.registerUtf8KeyHandler("a", Modifier::None, Action::Press, [&] { order += 'a'; });
+        im.handleEvents();
+        press();
+        CHECK(order == "bk");
+
+        // a consuming utf8 handler ranked first hides the scancode chain behind it
+        im.setDefaultHandlerPriority(0);
+        InputManager::ScopedCallbackHandler first = im.registerUtf8KeyHandler("a", Modifier::None, Action::Press, [&] { order += 'f'; return true; });
+        im.handleEvents();
+        press();
+        CHECK(order == "f");
+
+        // without a consumer every handler runs, scancode handlers first among equal priorities
+        first.reset();
+        key.reset();
+        im.setDefaultHandlerPriority(1);
+        InputManager::ScopedCallbackHandler tied = im.registerKeyHandler(ScancodeA, Modifier::None, Action::Press, [&] { order += 't'; });
+        im.handleEvents();
+        press();
+        CHECK(order == "tba");
+
+        im.setCurrentKeyboardHandlerPriority(0);
+        im.setDefaultHandlerPriority(0);
+    }
+}
+
+int main() {
+    auto window = glfwstub::createWindow();
+    auto im = std::make_unique<InputManager>();
+    im->initialize(window);
+
+    releaseWithoutPress(*im, window);
+    chainsInterleaveByPriority(*im, window);
+
+    im.reset();
+    glfwstub::destroyWindow(window);
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Publishing snapshots must not touch the heap: the global operator new is replaced by a counting one and a
+// steady stream of input events, pollEvents() and updateInputState() publishes and frame reads runs without
+// a single allocation. The monitor topology is only rebuilt (and allocated) when a monitor event dirties it.
+#include <glfwim/input_manager.hpp>
+#include <glfw_stub.hpp>
+#include "check.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+using namespace glfwim;
+
+namespace {
+    std::atomic<uint64_t> allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order::relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1)) return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order::relaxed);
+    if (void* p = std::aligned_alloc((std::size_t)alignment, (size + (std::size_t)alignment - 1) & ~((std::size_t)alignment - 1))) return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+    constexpr int Frames = 1000;
+
+    // one frame worth of input: a key tap, a click, cursor moves (each publishes from its callback) and a poll
+    void frame(InputManager& im, GLFWwindow* window, int i) {
+        int key = 'A' + i % 26;
+        glfwstub::key(window, key, key, GLFW_PRESS);
+        glfwstub::mouseButton(window, i % 3, GLFW_PRESS);
+        glfwstub::cursorPos(window, i % 1280, i % 720);
+        glfwstub::key(window, key, key, GLFW_RELEASE);
+        glfwstub::mouseButton(window, i % 3, GLFW_RELEASE);
+        glfwstub::cursorPos(window, (i + 1) % 1280, (i + 1) % 720);
+        glfwstub::advanceTime(1.0 / 60);
+        im.pollEvents();
+        im.handleEvents();
+
+        auto snapshot = im.acquireSnapshot();
+        CHECK(snapshot->wasKeyPressed(key));
+        im.consumeEdges(snapshot);
+        im.releaseSnapshot(snapshot);
+    }
+}
+
+int main() {
+    auto window = glfwstub::createWindow();
+    auto im = std::make_unique<InputManager>();
+    im->initialize(window);
+
+    // the event queue and handler storage reach their steady state size first
+    for (int i = 0; i < Frames; ++i) frame(*im, window, i);
+
+    auto topology = im->getMonitorTopology();
+    unsigned version = topology->version;
+    uint64_t before = allocations.load();
+    for (int i = 0; i < Frames; ++i) frame(*im, window, i);
+    CHECK(allocations.load() == before);
+    CHECK(im->getMonitorTopology() == topology);
+
+    // a monitor event dirties MonitorField, the next publish rebuilds the topology once
+    glfwstub::monitorEvent(GLFW_CONNECTED);
+    before = allocations.load();
+    im->pollEvents();
+    CHECK(allocations.load() > before);
+    auto rebuilt = im->getMonitorTopology();
+    CHECK(rebuilt != topology);
+    CHECK(rebuilt->version == version + 1);
+    im->handleEvents();
+
+    before = allocations.load();
+    frame(*im, window, 0);
+    CHECK(allocations.load() == before);
+    CHECK(im->getMonitorTopology() == rebuilt);
+
+    topology.reset();
+    rebuilt.reset();
+    im.reset();
+    glfwstub::destroyWindow(window);
+    return 0;
+}
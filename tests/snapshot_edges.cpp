@@ -0,0 +1,95 @@
+// Pressed and released edges stay in the published snapshots until the frame consumer calls consumeEdges(), no
+// matter how many publishes (cursor moves, window events) happen in between, and an edge published after the
+// consumed snapshot survives the consume.
+#include <glfwim/input_manager.hpp>
+#include <glfw_stub.hpp>
+#include "check.hpp"
+
+#include <memory>
+
+using namespace glfwim;
+
+namespace {
+    constexpr int KeyA = 'A', KeyB = 'B';
+
+    struct Frame {
+        InputManager& im;
+        const PerFrameGlobalInputData* snapshot;
+
+        explicit Frame(InputManager& im) : im{im}, snapshot{im.acquireSnapshot()} {}
+        ~Frame() {
+            im.consumeEdges(snapshot);
+            im.releaseSnapshot(snapshot);
+        }
+    };
+
+    void edgesOutlivePublishes(InputManager& im, GLFWwindow* window) {
+        glfwstub::key(window, KeyA, KeyA, GLFW_PRESS);
+        glfwstub::cursorPos(window, 10, 10);
+        glfwstub::cursorPos(window, 20, 20);
+        im.pollEvents();
+        {
+            Frame frame{im};
+            CHECK(frame.snapshot->isKeyDown(KeyA));
+            CHECK(frame.snapshot->wasKeyPressed(KeyA));
+        }
+
+        glfwstub::cursorPos(window, 30, 30);
+        im.pollEvents();
+        {
+            Frame frame{im};
+            CHECK(frame.snapshot->isKeyDown(KeyA));
+            CHECK(!frame.snapshot->wasKeyPressed(KeyA));
+        }
+
+        glfwstub::mouseButton(window, 0, GLFW_PRESS);
+        glfwstub::mouseButton(window, 0, GLFW_RELEASE);
+        glfwstub::key(window, KeyA, KeyA, GLFW_RELEASE);
+        glfwstub::cursorPos(window, 40, 40);
+        im.pollEvents();
+        {
+            Frame frame{im};
+            CHECK(!frame.snapshot->isKeyDown(KeyA));
+            CHECK(frame.snapshot->wasKeyReleased(KeyA));
+            CHECK(frame.snapshot->wasMouseButtonPressed(MouseButton::Left));
+            CHECK(frame.snapshot->wasMouseButtonReleased(MouseButton::Left));
+        }
+    }
+
+    // the consumer read an older snapshot than the one published when it consumes
+    void edgesAfterTheConsumedSnapshotSurvive(InputManager& im, GLFWwindow* window) {
+        auto stale = im.acquireSnapshot();
+        glfwstub::key(window, KeyB, KeyB, GLFW_PRESS);
+        im.pollEvents();
+        glfwstub::cursorPos(window, 50, 50);
+        uint64_t staleSequence = stale->sequence;
+        im.consumeEdges(stale);
+        im.releaseSnapshot(stale);
+        im.pollEvents();
+        {
+            Frame frame{im};
+            CHECK(frame.snapshot->sequence > staleSequence);
+            CHECK(frame.snapshot->wasKeyPressed(KeyB));
+            CHECK(!frame.snapshot->wasKeyReleased(KeyA));
+        }
+
+        // consuming with nothing else happening still clears the edges on the next publish
+        im.pollEvents();
+        auto snapshot = im.acquireSnapshot();
+        CHECK(!snapshot->wasKeyPressed(KeyB));
+        im.releaseSnapshot(snapshot);
+    }
+}
+
+int main() {
+    auto window = glfwstub::createWindow();
+    auto im = std::make_unique<InputManager>();
+    im->initialize(window);
+
+    edgesOutlivePublishes(*im, window);
+    edgesAfterTheConsumedSnapshotSurvive(*im, window);
+
+    im.reset();
+    glfwstub::destroyWindow(window);
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Readers acquire and hold snapshots on several threads while the poll thread keeps publishing new ones. A held
+// snapshot must stay byte for byte unchanged until it is released (its slot has readers > 0, so the writer must
+// pick another one or skip the publish), and acquireSnapshot() must never hand out a slot that was already retired,
+// i.e. one older than a snapshot published before the acquire started. Meant to run under -fsanitize=thread.
+#include <glfwim/input_manager.hpp>
+#include <glfw_stub.hpp>
+#include "check.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace glfwim;
+
+namespace {
+    constexpr int ReaderCount = 3;
+    constexpr int PollIterations = 20000;
+
+    // timestamp of a snapshot the poll thread saw published, every later acquire must return one at least as new
+    std::atomic<double> publishedFloor = 0.0;
+    std::atomic<uint64_t> heldAcrossPublish = 0;
+
+    void reader(InputManager& im, const std::atomic<bool>& stop, int id) {
+        auto copy = std::make_unique<unsigned char[]>(sizeof(PerFrameGlobalInputData));
+        double lastSeen = 0.0;
+        uint64_t round = 0;
+        while (!stop.load()) {
+            double floor = publishedFloor.load();
+            auto snapshot = im.acquireSnapshot();
+            CHECK(snapshot->timestamp >= floor);
+            CHECK(snapshot->timestamp >= lastSeen);
+            lastSeen = snapshot->timestamp;
+
+            std::memcpy(copy.get(), snapshot, sizeof(PerFrameGlobalInputData));
+            // hold it for a while, sometimes long enough for every spare slot to be taken
+            int holdFor = (round++ + id) % 8 == 0 ? 64 : 4;
+            for (int i = 0; i < holdFor; ++i) std::this_thread::yield();
+            CHECK(std::memcmp(copy.get(), snapshot, sizeof(PerFrameGlobalInputData)) == 0);
+            if (publishedFloor.load() > snapshot->timestamp) heldAcrossPublish.fetch_add(1);
+            im.releaseSnapshot(snapshot);
+        }
+    }
+
+    // every iteration dirties the snapshot, so each poll publishes unless all spare slots are being read
+    void pollOnce(InputManager& im, GLFWwindow* window, int i) {
+        glfwstub::advanceTime(0.001);
+        glfwstub::cursorPos(window, i % 640, i % 480);
+        if (i % 5 == 0) glfwstub::key(window, 'A' + i % 26, i % 26, (i / 5) % 2 ? GLFW_RELEASE : GLFW_PRESS);
+        im.pollEvents();
+
+        auto snapshot = im.acquireSnapshot();
+        publishedFloor.store(snapshot->timestamp);
+        im.releaseSnapshot(snapshot);
+    }
+}
+
+int main() {
+    auto window = glfwstub::createWindow();
+    auto im = std::make_unique<InputManager>();
+    im->initialize(window);
+
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < ReaderCount; ++i) {
+        readers.emplace_back(reader, std::ref(*im), std::cref(stop), i);
+    }
+    for (int i = 0; i < PollIterations; ++i) {
+        pollOnce(*im, window, i);
+        // the event queue is not under test here
+        if (i % 64 == 0) im->handleEvents();
+    }
+    stop.store(true);
+    for (auto& t : readers) t.join();
+    CHECK(heldAcrossPublish.load() > 0);
+
+    // publishes skipped while every spare slot was read are caught up once a slot frees up
+    pollOnce(*im, window, PollIterations);
+    auto snapshot = im->acquireSnapshot();
+    CHECK(snapshot->timestamp == glfwGetTime());
+    auto viewport = snapshot->findViewport(window);
+    CHECK(viewport != nullptr && viewport->cursorX == PollIterations % 640);
+    im->releaseSnapshot(snapshot);
+
+    im.reset();
+    glfwstub::destroyWindow(window);
+    return 0;
+}
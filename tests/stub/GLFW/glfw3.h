@@ -0,0 +1,118 @@
+#ifndef GLFW_STUB_GLFW3_H
+#define GLFW_STUB_GLFW3_H
+
+// The subset of the GLFW 3.3 API used by glfwim, implemented by glfw_stub.cpp without a display so the
+// input manager can be driven from tests and benchmarks. See glfw_stub.hpp for the test side controls.
+
+#define GLFW_RELEASE 0
+#define GLFW_PRESS 1
+#define GLFW_REPEAT 2
+
+#define GLFW_KEY_UNKNOWN -1
+#define GLFW_KEY_SPACE 32
+#define GLFW_KEY_ENTER 257
+#define GLFW_KEY_RIGHT 262
+#define GLFW_KEY_LEFT 263
+#define GLFW_KEY_LAST 348
+
+#define GLFW_FOCUSED 0x00020001
+#define GLFW_ICONIFIED 0x00020002
+#define GLFW_HOVERED 0x0002000B
+
+#define GLFW_CURSOR 0x00033001
+#define GLFW_CURSOR_NORMAL 0x00034001
+#define GLFW_CURSOR_HIDDEN 0x00034002
+#define GLFW_CURSOR_DISABLED 0x00034003
+
+#define GLFW_CONNECTED 0x00040001
+#define GLFW_DISCONNECTED 0x00040002
+
+#define GLFW_JOYSTICK_1 0
+#define GLFW_JOYSTICK_LAST 15
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct GLFWwindow GLFWwindow;
+typedef struct GLFWmonitor GLFWmonitor;
+
+typedef struct GLFWvidmode {
+    int width, height, redBits, greenBits, blueBits, refreshRate;
+} GLFWvidmode;
+
+typedef struct GLFWgamepadstate {
+    unsigned char buttons[15];
+    float axes[6];
+} GLFWgamepadstate;
+
+typedef void (*GLFWkeyfun)(GLFWwindow*, int, int, int, int);
+typedef void (*GLFWcharfun)(GLFWwindow*, unsigned int);
+typedef void (*GLFWmousebuttonfun)(GLFWwindow*, int, int, int);
+typedef void (*GLFWcursorposfun)(GLFWwindow*, double, double);
+typedef void (*GLFWcursorenterfun)(GLFWwindow*, int);
+typedef void (*GLFWscrollfun)(GLFWwindow*, double, double);
+typedef void (*GLFWdropfun)(GLFWwindow*, int, const char**);
+typedef void (*GLFWwindowposfun)(GLFWwindow*, int, int);
+typedef void (*GLFWframebuffersizefun)(GLFWwindow*, int, int);
+typedef void (*GLFWwindowcontentscalefun)(GLFWwindow*, float, float);
+typedef void (*GLFWwindowfocusfun)(GLFWwindow*, int);
+typedef void (*GLFWwindowclosefun)(GLFWwindow*);
+typedef void (*GLFWmonitorfun)(GLFWmonitor*, int);
+typedef void (*GLFWjoystickfun)(int, int);
+
+double glfwGetTime(void);
+void glfwPollEvents(void);
+void glfwWaitEvents(void);
+void glfwWaitEventsTimeout(double timeout);
+void glfwPostEmptyEvent(void);
+
+void glfwSetWindowUserPointer(GLFWwindow* window, void* pointer);
+void* glfwGetWindowUserPointer(GLFWwindow* window);
+int glfwGetWindowAttrib(GLFWwindow* window, int attrib);
+void glfwGetWindowPos(GLFWwindow* window, int* xpos, int* ypos);
+void glfwGetWindowSize(GLFWwindow* window, int* width, int* height);
+void glfwGetFramebufferSize(GLFWwindow* window, int* width, int* height);
+void glfwGetCursorPos(GLFWwindow* window, double* xpos, double* ypos);
+int glfwGetMouseButton(GLFWwindow* window, int button);
+int glfwGetInputMode(GLFWwindow* window, int mode);
+void glfwSetInputMode(GLFWwindow* window, int mode, int value);
+const char* glfwGetClipboardString(GLFWwindow* window);
+void glfwSetClipboardString(GLFWwindow* window, const char* string);
+const char* glfwGetKeyName(int key, int scancode);
+int glfwGetKeyScancode(int key);
+
+GLFWkeyfun glfwSetKeyCallback(GLFWwindow* window, GLFWkeyfun callback);
+GLFWcharfun glfwSetCharCallback(GLFWwindow* window, GLFWcharfun callback);
+GLFWmousebuttonfun glfwSetMouseButtonCallback(GLFWwindow* window, GLFWmousebuttonfun callback);
+GLFWcursorposfun glfwSetCursorPosCallback(GLFWwindow* window, GLFWcursorposfun callback);
+GLFWcursorenterfun glfwSetCursorEnterCallback(GLFWwindow* window, GLFWcursorenterfun callback);
+GLFWscrollfun glfwSetScrollCallback(GLFWwindow* window, GLFWscrollfun callback);
+GLFWdropfun glfwSetDropCallback(GLFWwindow* window, GLFWdropfun callback);
+GLFWwindowposfun glfwSetWindowPosCallback(GLFWwindow* window, GLFWwindowposfun callback);
+GLFWframebuffersizefun glfwSetFramebufferSizeCallback(GLFWwindow* window, GLFWframebuffersizefun callback);
+GLFWwindowcontentscalefun glfwSetWindowContentScaleCallback(GLFWwindow* window, GLFWwindowcontentscalefun callback);
+GLFWwindowfocusfun glfwSetWindowFocusCallback(GLFWwindow* window, GLFWwindowfocusfun callback);
+GLFWwindowclosefun glfwSetWindowCloseCallback(GLFWwindow* window, GLFWwindowclosefun callback);
+
+GLFWmonitor** glfwGetMonitors(int* count);
+void glfwSetMonitorUserPointer(GLFWmonitor* monitor, void* pointer);
+void* glfwGetMonitorUserPointer(GLFWmonitor* monitor);
+const GLFWvidmode* glfwGetVideoMode(GLFWmonitor* monitor);
+void glfwGetMonitorPos(GLFWmonitor* monitor, int* xpos, int* ypos);
+void glfwGetMonitorWorkarea(GLFWmonitor* monitor, int* xpos, int* ypos, int* width, int* height);
+void glfwGetMonitorContentScale(GLFWmonitor* monitor, float* xscale, float* yscale);
+GLFWmonitorfun glfwSetMonitorCallback(GLFWmonitorfun callback);
+
+int glfwJoystickPresent(int jid);
+int glfwJoystickIsGamepad(int jid);
+const float* glfwGetJoystickAxes(int jid, int* count);
+const unsigned char* glfwGetJoystickButtons(int jid, int* count);
+int glfwGetGamepadState(int jid, GLFWgamepadstate* state);
+GLFWjoystickfun glfwSetJoystickCallback(GLFWjoystickfun callback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
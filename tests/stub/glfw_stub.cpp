@@ -0,0 +1,145 @@
+#include "glfw_stub.hpp"
+
+#include <atomic>
+#include <string>
+
+struct GLFWwindow {
+    void* userPointer = nullptr;
+    int width, height;
+    double cursorX = 0, cursorY = 0;
+    int mouseButtons[8] = {};
+    int cursorMode = GLFW_CURSOR_NORMAL;
+    GLFWkeyfun keyCallback = nullptr;
+    GLFWmousebuttonfun mouseButtonCallback = nullptr;
+    GLFWcursorposfun cursorPosCallback = nullptr;
+};
+
+struct GLFWmonitor {
+    void* userPointer = nullptr;
+};
+
+namespace {
+    std::atomic<double> currentTime = 0.0;
+    std::atomic<uint64_t> emptyEvents = 0;
+    GLFWmonitor primaryMonitor;
+    GLFWmonitor* monitors[] = { &primaryMonitor };
+    const GLFWvidmode videoMode = { 1920, 1080, 8, 8, 8, 60 };
+    GLFWmonitorfun monitorCallback = nullptr;
+    // joysticks without axes or buttons, only their presence is simulated
+    bool joysticksPresent[GLFW_JOYSTICK_LAST + 1] = {};
+    GLFWjoystickfun joystickCallback = nullptr;
+    std::string clipboard;
+
+    template <typename F>
+    F exchangeCallback(F& slot, F callback) {
+        F previous = slot;
+        slot = callback;
+        return previous;
+    }
+}
+
+namespace glfwstub {
+    GLFWwindow* createWindow(int width, int height) {
+        auto window = new GLFWwindow{};
+        window->width = width;
+        window->height = height;
+        return window;
+    }
+
+    void destroyWindow(GLFWwindow* window) {
+        delete window;
+    }
+
+    void setTime(double seconds) {
+        currentTime.store(seconds);
+    }
+
+    void advanceTime(double seconds) {
+        currentTime.store(currentTime.load() + seconds);
+    }
+
+    void key(GLFWwindow* window, int key, int scancode, int action, int mods) {
+        if (window->keyCallback) window->keyCallback(window, key, scancode, action, mods);
+    }
+
+    void mouseButton(GLFWwindow* window, int button, int action, int mods) {
+        window->mouseButtons[button] = action;
+        if (window->mouseButtonCallback) window->mouseButtonCallback(window, button, action, mods);
+    }
+
+    void cursorPos(GLFWwindow* window, double x, double y) {
+        window->cursorX = x;
+        window->cursorY = y;
+        if (window->cursorPosCallback) window->cursorPosCallback(window, x, y);
+    }
+
+    void monitorEvent(int event) {
+        if (monitorCallback) monitorCallback(&primaryMonitor, event);
+    }
+
+    void joystick(int jid, bool connected) {
+        joysticksPresent[jid] = connected;
+        if (joystickCallback) joystickCallback(jid, connected ? GLFW_CONNECTED : GLFW_DISCONNECTED);
+    }
+
+    uint64_t emptyEventCount() {
+        return emptyEvents.load();
+    }
+}
+
+extern "C" {
+    double glfwGetTime(void) { return currentTime.load(); }
+    void glfwPollEvents(void) {}
+    void glfwWaitEvents(void) {}
+    void glfwWaitEventsTimeout(double) {}
+    void glfwPostEmptyEvent(void) { emptyEvents.fetch_add(1); }
+
+    void glfwSetWindowUserPointer(GLFWwindow* window, void* pointer) { window->userPointer = pointer; }
+    void* glfwGetWindowUserPointer(GLFWwindow* window) { return window->userPointer; }
+    int glfwGetWindowAttrib(GLFWwindow*, int attrib) { return attrib == GLFW_FOCUSED || attrib == GLFW_HOVERED; }
+    void glfwGetWindowPos(GLFWwindow*, int* xpos, int* ypos) { *xpos = 0; *ypos = 0; }
+    void glfwGetWindowSize(GLFWwindow* window, int* width, int* height) { *width = window->width; *height = window->height; }
+    void glfwGetFramebufferSize(GLFWwindow* window, int* width, int* height) { *width = window->width; *height = window->height; }
+    void glfwGetCursorPos(GLFWwindow* window, double* xpos, double* ypos) { *xpos = window->cursorX; *ypos = window->cursorY; }
+    int glfwGetMouseButton(GLFWwindow* window, int button) { return window->mouseButtons[button]; }
+    int glfwGetInputMode(GLFWwindow* window, int) { return window->cursorMode; }
+    void glfwSetInputMode(GLFWwindow* window, int mode, int value) { if (mode == GLFW_CURSOR) window->cursorMode = value; }
+    const char* glfwGetClipboardString(GLFWwindow*) { return clipboard.c_str(); }
+    void glfwSetClipboardString(GLFWwindow*, const char* string) { clipboard = string; }
+    // the printable letter keys are named like a US layout, everything else is unnamed
+    const char* glfwGetKeyName(int key, int) {
+        static constexpr const char* letters[] = {"a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m",
+            "n", "o", "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z"};
+        return key >= 'A' && key <= 'Z' ? letters[key - 'A'] : nullptr;
+    }
+    int glfwGetKeyScancode(int key) { return key; }
+
+    GLFWkeyfun glfwSetKeyCallback(GLFWwindow* window, GLFWkeyfun callback) { return exchangeCallback(window->keyCallback, callback); }
+    GLFWcharfun glfwSetCharCallback(GLFWwindow*, GLFWcharfun) { return nullptr; }
+    GLFWmousebuttonfun glfwSetMouseButtonCallback(GLFWwindow* window, GLFWmousebuttonfun callback) { return exchangeCallback(window->mouseButtonCallback, callback); }
+    GLFWcursorposfun glfwSetCursorPosCallback(GLFWwindow* window, GLFWcursorposfun callback) { return exchangeCallback(window->cursorPosCallback, callback); }
+    GLFWcursorenterfun glfwSetCursorEnterCallback(GLFWwindow*, GLFWcursorenterfun) { return nullptr; }
+    GLFWscrollfun glfwSetScrollCallback(GLFWwindow*, GLFWscrollfun) { return nullptr; }
+    GLFWdropfun glfwSetDropCallback(GLFWwindow*, GLFWdropfun) { return nullptr; }
+    GLFWwindowposfun glfwSetWindowPosCallback(GLFWwindow*, GLFWwindowposfun) { return nullptr; }
+    GLFWframebuffersizefun glfwSetFramebufferSizeCallback(GLFWwindow*, GLFWframebuffersizefun) { return nullptr; }
+    GLFWwindowcontentscalefun glfwSetWindowContentScaleCallback(GLFWwindow*, GLFWwindowcontentscalefun) { return nullptr; }
+    GLFWwindowfocusfun glfwSetWindowFocusCallback(GLFWwindow*, GLFWwindowfocusfun) { return nullptr; }
+    GLFWwindowclosefun glfwSetWindowCloseCallback(GLFWwindow*, GLFWwindowclosefun) { return nullptr; }
+
+    GLFWmonitor** glfwGetMonitors(int* count) { *count = 1; return monitors; }
+    void glfwSetMonitorUserPointer(GLFWmonitor* monitor, void* pointer) { monitor->userPointer = pointer; }
+    void* glfwGetMonitorUserPointer(GLFWmonitor* monitor) { return monitor->userPointer; }
+    const GLFWvidmode* glfwGetVideoMode(GLFWmonitor*) { return &videoMode; }
+    void glfwGetMonitorPos(GLFWmonitor*, int* xpos, int* ypos) { *xpos = 0; *ypos = 0; }
+    void glfwGetMonitorWorkarea(GLFWmonitor*, int* xpos, int* ypos, int* width, int* height) { *xpos = 0; *ypos = 0; *width = videoMode.width; *height = videoMode.height; }
+    void glfwGetMonitorContentScale(GLFWmonitor*, float* xscale, float* yscale) { *xscale = 1.0f; *yscale = 1.0f; }
+    GLFWmonitorfun glfwSetMonitorCallback(GLFWmonitorfun callback) { return exchangeCallback(monitorCallback, callback); }
+
+    int glfwJoystickPresent(int jid) { return joysticksPresent[jid]; }
+    int glfwJoystickIsGamepad(int) { return 0; }
+    const float* glfwGetJoystickAxes(int, int* count) { *count = 0; return nullptr; }
+    const unsigned char* glfwGetJoystickButtons(int, int* count) { *count = 0; return nullptr; }
+    int glfwGetGamepadState(int, GLFWgamepadstate*) { return 0; }
+    GLFWjoystickfun glfwSetJoystickCallback(GLFWjoystickfun callback) { return exchangeCallback(joystickCallback, callback); }
+}
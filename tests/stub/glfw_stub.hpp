@@ -0,0 +1,29 @@
+#ifndef GLFW_STUB_HPP
+#define GLFW_STUB_HPP
+
+#include <cstdint>
+#include <GLFW/glfw3.h>
+
+// Test side of the GLFW stub: a manually advanced clock and entry points that invoke the callbacks glfwim
+// installed, as GLFW would from glfwPollEvents(). Events must be injected on the thread calling pollEvents().
+namespace glfwstub {
+    GLFWwindow* createWindow(int width = 1280, int height = 720);
+    void destroyWindow(GLFWwindow* window);
+
+    // glfwGetTime() only moves through these, so hold timers fire exactly when a test lets them
+    void setTime(double seconds);
+    void advanceTime(double seconds);
+
+    void key(GLFWwindow* window, int key, int scancode, int action, int mods = 0);
+    void mouseButton(GLFWwindow* window, int button, int action, int mods = 0);
+    void cursorPos(GLFWwindow* window, double x, double y);
+    // reports a configuration change of the single stub monitor, e.g. GLFW_CONNECTED
+    void monitorEvent(int event);
+    // plugs or unplugs a joystick without axes or buttons
+    void joystick(int jid, bool connected);
+
+    // glfwPostEmptyEvent() calls since start, i.e. poll thread wake-ups requested by glfwim
+    uint64_t emptyEventCount();
+}
+
+#endif
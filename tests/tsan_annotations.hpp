@@ -0,0 +1,16 @@
+#ifndef GLFWIM_TESTS_TSAN_ANNOTATIONS_HPP
+#define GLFWIM_TESTS_TSAN_ANNOTATIONS_HPP
+
+// Force-included into ThreadSanitizer builds. The vendored moodycamel queues synchronize through standalone
+// fences, which ThreadSanitizer does not model, and only annotate them when __has_feature(thread_sanitizer)
+// says so, i.e. under clang. GCC signals the sanitizer through __SANITIZE_THREAD__ instead, so the same
+// annotations are supplied here.
+#if defined(__SANITIZE_THREAD__) && !defined(AE_TSAN_ANNOTATE_RELEASE)
+extern "C" void AnnotateHappensBefore(const char* file, int line, void* address);
+extern "C" void AnnotateHappensAfter(const char* file, int line, void* address);
+namespace glfwim_tests { inline int tsanFence; }
+#define AE_TSAN_ANNOTATE_RELEASE() AnnotateHappensBefore(__FILE__, __LINE__, (void*)&::glfwim_tests::tsanFence)
+#define AE_TSAN_ANNOTATE_ACQUIRE() AnnotateHappensAfter(__FILE__, __LINE__, (void*)&::glfwim_tests::tsanFence)
+#endif
+
+#endif